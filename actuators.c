@@ -5,6 +5,9 @@
 #include <softTone.h>
 #include "config.h"     // 핀 번호(BUZZER_PIN)와 모드(MODE_...) 정의 가져옴
 #include "actuators.h"  // 함수 원형
+#include "watchdog.h"
+#include "governor.h"
+#include "clock.h"
 
 // --- SPI 설정 ---
 #define SPI_CH 0
@@ -103,30 +106,31 @@ void* displayThreadFunc(void* arg) {
         pthread_mutex_unlock(&mode_mutex);
 
         if (local_mode == MODE_EXIT) break;
+        watchdog_beat(HB_DISPLAY);
 
         switch (local_mode) {
             case MODE_SAFE:
                 render_dual(ICON_LOCK, ICON_SMILE);
-                delay(200); 
+                governor_sleep_ms(governor_period_ms(GOV_DISPLAY)); // 한가할수록 갱신 주기 증가
                 break;
 
             case MODE_WARN:
                 render_dual(ICON_WARN_TRIANGLE, ICON_EXCLAMATION);
-                delay(200);
+                clock_sleep_ms(200);
                 break;
 
             case MODE_DANGER:
                 // 위험 모드는 깜빡임 효과 (Animation)
                 render_dual(ICON_SKULL, ICON_X);
-                delay(200); 
+                clock_sleep_ms(200); 
                 render_dual(ICON_CLEAR, ICON_CLEAR); // 껐다
-                delay(200); 
+                clock_sleep_ms(200); 
                 break;
 
             case MODE_CLEAR:
             default:
                 render_dual(ICON_CLEAR, ICON_CLEAR);
-                delay(200);
+                governor_sleep_ms(governor_period_ms(GOV_DISPLAY));
                 break;
         }
     }
@@ -143,15 +147,16 @@ void* buzzerThreadFunc(void* arg) {
         pthread_mutex_unlock(&mode_mutex);
 
         if (local_mode == MODE_EXIT) break;
+        watchdog_beat(HB_BUZZER);
 
         switch (local_mode) {
             
             // [경고] 1초 간격 "삑... 삑..."
             case MODE_WARN:
                 softToneWrite(BUZZER_PIN, 1000); // 1000Hz 켜기
-                delay(200); 
+                clock_sleep_ms(200); 
                 softToneWrite(BUZZER_PIN, 0);    // 끄기
-                delay(800);
+                clock_sleep_ms(800);
                 break;
 
             // [위험] 경찰차 사이렌 (Frequency Sweep)
@@ -166,7 +171,7 @@ void* buzzerThreadFunc(void* arg) {
                     }
                     pthread_mutex_unlock(&mode_mutex);
                     softToneWrite(BUZZER_PIN, freq);
-                    delay(5); 
+                    clock_sleep_ms(5); 
                 }
                 
                 // 주파수 하강 (1500 -> 500)
@@ -178,7 +183,7 @@ void* buzzerThreadFunc(void* arg) {
                     }
                     pthread_mutex_unlock(&mode_mutex);
                     softToneWrite(BUZZER_PIN, freq);
-                    delay(5);
+                    clock_sleep_ms(5);
                 }
                 break;
 
@@ -187,7 +192,7 @@ void* buzzerThreadFunc(void* arg) {
             case MODE_CLEAR:
             default:
                 softToneWrite(BUZZER_PIN, 0);
-                delay(100); 
+                governor_sleep_ms(governor_period_ms(GOV_BUZZER));
                 break;
         }
 
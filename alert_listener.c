@@ -0,0 +1,231 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <endian.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+
+#include "config.h"
+#include "alert_proto.h"
+
+// =========================================================
+// 멀티캐스트 경보 수신기 (관제 PC / 시험용)
+// =========================================================
+// 사용법: ./alert_listener [-g 그룹] [-p 포트] [-i 수신 인터페이스 주소] [-t TCP 포트]
+//                          [-l 손실%(시험용 인위적 패킷 버림)] [-n 경보 수 (받으면 종료)]
+//
+// 장치(unit)마다 다음에 받을 번호를 기억하고,
+// - 패킷에 함께 실린 직전 경보 / 하트비트로 빈 번호를 채우고
+// - 그래도 빠진 번호는 보낸 장치에 TCP 로 "RESEND <seq>" 를 요청해 따라잡습니다.
+// 루프백 시험: config.h 의 ALERT_MCAST_IFACE 를 "127.0.0.1" 로 두고 ./alert_listener -i 127.0.0.1
+
+#define MAX_UNITS 16
+
+typedef struct {
+    int used;
+    uint16_t unit_id;
+    uint32_t boot_id;
+    uint32_t next_seq;       // 다음에 받을 번호
+    struct in_addr addr;     // 보낸 장치 주소 (TCP 따라잡기용)
+} unit_state_t;
+
+typedef enum { VIA_MCAST, VIA_REDUNDANT, VIA_HEARTBEAT, VIA_TCP } via_t;
+static const char* via_names[] = { "mcast", "redundant", "heartbeat", "tcp" };
+
+static unit_state_t units[MAX_UNITS];
+static long stats_via[4];
+static long stats_lost = 0;         // TCP 로도 못 받은 번호 (기록 밖으로 밀려남)
+static long stats_dropped_sim = 0;  // -l 로 버린 패킷
+static long stats_tcp_requests = 0;
+static double latency_sum_ms = 0;
+static long latency_count = 0;
+static int tcp_port = WIFI_SERVER_PORT;
+static volatile int running = 1;
+
+static uint64_t real_ms() {
+    struct timespec t;
+    clock_gettime(CLOCK_REALTIME, &t);
+    return (uint64_t)t.tv_sec * 1000 + t.tv_nsec / 1000000;
+}
+
+static void on_sigint(int sig) {
+    running = 0;
+}
+
+static unit_state_t* find_unit(uint16_t unit_id) {
+    for (int i = 0; i < MAX_UNITS; i++) {
+        if (units[i].used && units[i].unit_id == unit_id) return &units[i];
+    }
+    for (int i = 0; i < MAX_UNITS; i++) {
+        if (!units[i].used) {
+            units[i].used = 1;
+            units[i].unit_id = unit_id;
+            return &units[i];
+        }
+    }
+    return NULL;
+}
+
+static void deliver(unit_state_t* u, uint32_t seq, uint64_t ts_ms, int mode, const char* text, via_t via) {
+    double latency = (double)(int64_t)(real_ms() - ts_ms);
+    if (via == VIA_MCAST) {
+        latency_sum_ms += latency;
+        latency_count++;
+    }
+    stats_via[via]++;
+    printf("[unit %u] #%-5u mode=%d %-40s (%s, +%.0f ms)\n", u->unit_id, seq, mode, text, via_names[via], latency);
+    u->next_seq = seq + 1;
+}
+
+// 빠진 번호를 보낸 장치의 TCP 서버에서 받아옴 (next_seq .. upto-1)
+static void tcp_catch_up(unit_state_t* u, uint32_t upto) {
+    struct sockaddr_in addr = { .sin_family = AF_INET, .sin_port = htons(tcp_port), .sin_addr = u->addr };
+    struct timeval tv = { .tv_sec = 1, .tv_usec = 0 };
+    char line[ALERT_TEXT_LEN + 64];
+
+    stats_tcp_requests++;
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        perror("[Listener] TCP catch-up connect failed");
+        close(fd);
+        return;
+    }
+
+    int n = snprintf(line, sizeof(line), ALERT_RESEND_CMD " %u\n", u->next_seq);
+    send(fd, line, n, MSG_NOSIGNAL);
+
+    FILE* fp = fdopen(fd, "r");
+    while (fp != NULL && fgets(line, sizeof(line), fp) != NULL) {
+        unsigned int seq, mode;
+        unsigned long long ts;
+        int text_pos = 0;
+        if (strncmp(line, "END", 3) == 0) break;
+        if (sscanf(line, "ALERT %u %llu %u %n", &seq, &ts, &mode, &text_pos) < 3 || text_pos == 0) continue;
+        if (seq < u->next_seq || seq >= upto) continue;
+        line[strcspn(line, "\n")] = '\0';
+        stats_lost += seq - u->next_seq; // 기록 밖으로 밀려난 번호
+        deliver(u, seq, ts, mode, line + text_pos, VIA_TCP);
+    }
+    if (fp != NULL) fclose(fp);
+    else close(fd);
+}
+
+static void handle_packet(const unsigned char* pkt, int len, struct in_addr from) {
+    const alert_pkt_header_t* hdr = (const alert_pkt_header_t*)pkt;
+    const alert_pkt_entry_t* entries = (const alert_pkt_entry_t*)(pkt + sizeof(*hdr));
+
+    if (len < (int)sizeof(*hdr) || ntohl(hdr->magic) != ALERT_MAGIC) return;
+    if (len < (int)(sizeof(*hdr) + hdr->count * sizeof(alert_pkt_entry_t))) return;
+
+    unit_state_t* u = find_unit(ntohs(hdr->unit_id));
+    if (u == NULL) return;
+    u->addr = from;
+
+    uint32_t boot_id = ntohl(hdr->boot_id);
+    uint32_t latest = ntohl(hdr->latest_seq);
+    if (u->boot_id != boot_id) {
+        // 처음 보는 장치 또는 재부팅 -> 지금 패킷에 실린 가장 오래된 경보부터 받음
+        u->boot_id = boot_id;
+        u->next_seq = hdr->count ? ntohl(entries[hdr->count - 1].seq) : latest + 1;
+        printf("[Listener] Unit %u (boot %u) from %s, starting at #%u\n", u->unit_id, boot_id, inet_ntoa(from), u->next_seq);
+    }
+
+    // 가장 오래된 항목에서도 닿지 않는 빈 번호는 TCP 로
+    uint32_t oldest = hdr->count ? ntohl(entries[hdr->count - 1].seq) : latest + 1;
+    if (oldest > u->next_seq) {
+        tcp_catch_up(u, oldest);
+        if (oldest > u->next_seq) {
+            stats_lost += oldest - u->next_seq;
+            u->next_seq = oldest;
+        }
+    }
+
+    for (int i = hdr->count - 1; i >= 0; i--) {
+        const alert_pkt_entry_t* e = &entries[i];
+        uint32_t seq = ntohl(e->seq);
+        if (seq < u->next_seq) continue; // 이미 받음
+        char text[ALERT_TEXT_LEN];
+        memcpy(text, e->text, ALERT_TEXT_LEN);
+        text[ALERT_TEXT_LEN - 1] = '\0';
+        via_t via = (hdr->flags & ALERT_FLAG_HEARTBEAT) ? VIA_HEARTBEAT : (i == 0 ? VIA_MCAST : VIA_REDUNDANT);
+        deliver(u, seq, be64toh(e->real_ms), e->mode, text, via);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const char* group = ALERT_MCAST_GROUP;
+    const char* iface = "0.0.0.0";
+    int port = ALERT_MCAST_PORT;
+    int loss_pct = 0;
+    long stop_after = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-g") == 0 && i + 1 < argc) group = argv[++i];
+        else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) port = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc) iface = argv[++i];
+        else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) tcp_port = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc) loss_pct = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) stop_after = atol(argv[++i]);
+    }
+
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    int opt = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)); // 한 PC 에서 수신기 여러 개 실행 가능
+
+    struct sockaddr_in addr = { .sin_family = AF_INET, .sin_port = htons(port), .sin_addr.s_addr = htonl(INADDR_ANY) };
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        perror("[Listener] Bind failed");
+        return 1;
+    }
+
+    struct ip_mreq mreq;
+    inet_pton(AF_INET, group, &mreq.imr_multiaddr);
+    inet_pton(AF_INET, iface, &mreq.imr_interface);
+    if (setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0) {
+        perror("[Listener] Join group failed");
+        return 1;
+    }
+
+    // Ctrl+C 에서 recvfrom 이 깨어나도록 SA_RESTART 없이 등록
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_sigint;
+    sigaction(SIGINT, &sa, NULL);
+    srand(time(NULL));
+    printf(">>> [Listener] Joined %s:%d (interface %s, simulated loss %d%%)\n", group, port, iface, loss_pct);
+
+    unsigned char pkt[ALERT_PKT_MAX_SIZE];
+    while (running) {
+        struct sockaddr_in from;
+        socklen_t fromlen = sizeof(from);
+        int n = recvfrom(fd, pkt, sizeof(pkt), 0, (struct sockaddr*)&from, &fromlen);
+        if (n < 0) continue;
+        if (loss_pct > 0 && rand() % 100 < loss_pct) {
+            stats_dropped_sim++;
+            continue;
+        }
+        handle_packet(pkt, n, from.sin_addr);
+
+        long total = stats_via[VIA_MCAST] + stats_via[VIA_REDUNDANT] + stats_via[VIA_HEARTBEAT] + stats_via[VIA_TCP];
+        if (stop_after > 0 && total >= stop_after) break;
+    }
+
+    printf("\n=== Listener Summary ===\n");
+    printf("Delivered: mcast %ld, redundant %ld, heartbeat %ld, tcp %ld (%ld requests)\n",
+           stats_via[VIA_MCAST], stats_via[VIA_REDUNDANT], stats_via[VIA_HEARTBEAT],
+           stats_via[VIA_TCP], stats_tcp_requests);
+    printf("Lost: %ld, packets dropped by -l: %ld\n", stats_lost, stats_dropped_sim);
+    if (latency_count > 0) {
+        printf("Mean first-copy latency: %.2f ms\n", latency_sum_ms / latency_count);
+    }
+    close(fd);
+    return 0;
+}
@@ -0,0 +1,45 @@
+#ifndef ALERT_PROTO_H
+#define ALERT_PROTO_H
+
+#include <stdint.h>
+
+// UDP 멀티캐스트 경보 패킷 형식 (송신: network.c, 수신: alert_listener.c)
+// 모든 정수는 네트워크 바이트 순서
+//
+// [헤더][항목 0 = 최신][항목 1]...[항목 count-1 = 가장 오래됨]
+// - 새 경보 패킷: 새 경보 + 직전 경보 최대 ALERT_REDUNDANCY 개 (하나가 빠져도 다음 패킷으로 복구)
+// - 하트비트 패킷 (ALERT_FLAG_HEARTBEAT): 최신 번호 + 최근 경보 재전송 (마지막 경보 손실 감지용)
+// - 그보다 많이 빠지면 수신 측이 TCP "RESEND <seq>" 로 따라잡음
+
+#define ALERT_MAGIC          0x53424131u // "SBA1"
+#define ALERT_FLAG_HEARTBEAT 0x01
+#define ALERT_TEXT_LEN       56
+#define ALERT_MAX_ENTRIES    8
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint16_t unit_id;
+    uint8_t  count;       // 뒤따르는 항목 수
+    uint8_t  flags;
+    uint32_t boot_id;     // 재부팅하면 번호가 1부터 다시 시작하므로 구분용
+    uint32_t latest_seq;  // 지금까지 보낸 마지막 번호 (0: 아직 없음)
+} alert_pkt_header_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t seq;
+    uint64_t real_ms;     // 경보 발생 시각 (CLOCK_REALTIME, ms)
+    uint8_t  mode;        // MODE_WARN / MODE_DANGER, 상태 알림은 0
+    char     text[ALERT_TEXT_LEN]; // NUL 로 끝남
+} alert_pkt_entry_t;
+
+#define ALERT_PKT_MAX_SIZE (sizeof(alert_pkt_header_t) + ALERT_MAX_ENTRIES * sizeof(alert_pkt_entry_t))
+
+// TCP 따라잡기: 클라이언트가 "RESEND <from_seq>\n" 전송
+// -> 서버는 남아 있는 경보를 "ALERT <seq> <real_ms> <mode> <text>\n" 로 보내고 "END <latest_seq>\n" 로 끝냄
+#define ALERT_RESEND_CMD "RESEND"
+
+// 관리자 설정 변경: "ADMIN <password> RELOAD" 또는 "ADMIN <password> SET <key> <value>\n"
+// -> "OK v<설정 버전>\n" 또는 "ERR <이유>\n"
+#define ALERT_ADMIN_CMD "ADMIN"
+
+#endif // ALERT_PROTO_H
@@ -0,0 +1,126 @@
+import time
+
+import cv2
+import numpy as np
+
+# 움직임 물체 추적기 (Blob Tracker)
+# - 움직임 마스크를 연결 요소(Connected Component)로 나눠 덩어리(blob)를 찾고
+# - 이전 프레임의 추적 대상(track)과 중심점 거리로 연결
+# - 움직임이 멈춘 대상은 배경 모델과 비교해서 "아직 그 자리에 있는지" 확인
+#   (배경 모델은 추적 중인 영역을 제외하고 갱신하므로 멈춘 사람이 배경으로 흡수되지 않음)
+# 메모리는 배경 모델 1장 + 최대 MAX_TRACKS 개의 작은 상태뿐 (프레임 수와 무관)
+
+MAX_TRACKS = 8
+MIN_BLOB_AREA = 500         # 이보다 작은 덩어리는 잡음으로 무시 (기존 MIN_CONTOUR_AREA)
+ASSOC_DIST = 80             # 같은 대상으로 볼 최대 중심점 이동 거리 (px)
+CONFIRM_HITS = 2            # 이만큼 연속으로 보여야 "존재" 로 인정 (순간 잡음 제거)
+BG_ALPHA = 0.02             # 배경 모델 갱신 속도
+FG_THRESHOLD = 25           # 배경과 이만큼 다르면 전경 픽셀
+PRESENCE_FG_RATIO = 0.25    # 박스 안 전경 비율이 이 이상이면 멈춰 있어도 존재 유지
+MISS_FRAMES = 15            # 움직임도 전경도 없는 프레임이 이만큼 이어지면 추적 종료
+MAX_STATIONARY_S = 600      # 10분 동안 전혀 안 움직이면 배경으로 흡수 (프레임 수가 아니라 시간 - fps 는 2~20 으로 바뀜)
+
+
+class Track:
+    __slots__ = ("id", "x", "y", "w", "h", "cx", "cy", "hits", "misses", "still_since")
+
+    def __init__(self, track_id, box):
+        self.id = track_id
+        self.hits = 1
+        self.misses = 0
+        self.still_since = None  # 움직임이 끊긴 시각 (time.monotonic(), None: 이번 프레임에 움직임)
+        self.update_box(box)
+
+    def update_box(self, box):
+        self.x, self.y, self.w, self.h = box
+        self.cx = self.x + self.w / 2
+        self.cy = self.y + self.h / 2
+
+
+class BlobTracker:
+    def __init__(self, min_blob_area=MIN_BLOB_AREA):
+        self.min_blob_area = min_blob_area  # 카메라마다 (설치 거리에 따라) 다르게 설정
+        self.tracks = []
+        self.next_id = 1
+        self.bg = None        # float32 배경 모델
+        self.track_mask = None
+
+    def update(self, gray, motion_mask):
+        """프레임 1장 처리 후 존재(presence) 여부 반환 (motion_mask 가 None 이면 움직임 없음)"""
+        if self.bg is None:
+            self.bg = gray.astype(np.float32)
+            self.track_mask = np.zeros(gray.shape, np.uint8)
+
+        blobs = self._find_blobs(motion_mask) if motion_mask is not None else []
+        self._associate(blobs, gray, time.monotonic())
+        self._update_background(gray)
+
+        return any(t.hits >= CONFIRM_HITS for t in self.tracks)
+
+    def confirmed_tracks(self):
+        """존재로 인정된 추적 대상 (구역 매핑용)"""
+        return [t for t in self.tracks if t.hits >= CONFIRM_HITS]
+
+    def moving_tracks(self):
+        """이번 프레임에 실제로 움직인 확인된 대상 (멈춰 있는 대상 / 유령 추적 제외)"""
+        return [t for t in self.tracks if t.hits >= CONFIRM_HITS and t.still_since is None]
+
+    def _find_blobs(self, motion_mask):
+        count, _, stats, _ = cv2.connectedComponentsWithStats(motion_mask, connectivity=8)
+        blobs = []
+        for i in range(1, count):  # 0 은 배경
+            x, y, w, h, area = stats[i]
+            if area >= self.min_blob_area:
+                blobs.append((int(x), int(y), int(w), int(h)))
+        # 큰 덩어리부터 연결 (추적 슬롯이 모자라면 작은 것을 버림)
+        blobs.sort(key=lambda b: b[2] * b[3], reverse=True)
+        return blobs
+
+    def _associate(self, blobs, gray, now):
+        unmatched = list(range(len(blobs)))
+
+        # 1. 기존 대상마다 가장 가까운 덩어리 연결 (탐욕적)
+        for t in self.tracks:
+            best, best_d = None, None
+            gate = max(ASSOC_DIST, (t.w + t.h) / 2)
+            for i in unmatched:
+                x, y, w, h = blobs[i]
+                d = np.hypot(x + w / 2 - t.cx, y + h / 2 - t.cy)
+                if d <= gate and (best_d is None or d < best_d):
+                    best, best_d = i, d
+            if best is not None:
+                t.update_box(blobs[best])
+                t.hits += 1
+                t.misses = 0
+                t.still_since = None
+                unmatched.remove(best)
+            else:
+                # 2. 움직임이 없음 -> 멈춘 것인지, 사라진 것인지 배경과 비교
+                if t.still_since is None:
+                    t.still_since = now
+                if self._foreground_ratio(t, gray) >= PRESENCE_FG_RATIO and now - t.still_since < MAX_STATIONARY_S:
+                    t.misses = 0
+                else:
+                    t.misses += 1
+
+        self.tracks = [t for t in self.tracks if t.misses < MISS_FRAMES]
+
+        # 3. 남은 덩어리는 새 대상으로 등록 (최대 MAX_TRACKS)
+        for i in unmatched:
+            if len(self.tracks) >= MAX_TRACKS:
+                break
+            self.tracks.append(Track(self.next_id, blobs[i]))
+            self.next_id += 1
+
+    def _foreground_ratio(self, t, gray):
+        y0, y1 = t.y, t.y + t.h
+        x0, x1 = t.x, t.x + t.w
+        diff = cv2.absdiff(gray[y0:y1, x0:x1], cv2.convertScaleAbs(self.bg[y0:y1, x0:x1]))
+        return np.count_nonzero(diff > FG_THRESHOLD) / max(1, diff.size)
+
+    def _update_background(self, gray):
+        # 추적 중인 박스 안은 배경으로 학습하지 않음
+        self.track_mask[:] = 255
+        for t in self.tracks:
+            self.track_mask[t.y:t.y + t.h, t.x:t.x + t.w] = 0
+        cv2.accumulateWeighted(gray, self.bg, BG_ALPHA, mask=self.track_mask)
@@ -1,5 +1,9 @@
 #include "bluetooth.h"
 #include "config.h"
+#include "watchdog.h"
+#include "runtime_config.h"
+#include "clock.h"
+#include "log.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -76,11 +80,19 @@ int is_motor_locked() {
     return locked;
 }
 
+void get_auth_state(int* user_count, int* override) {
+    pthread_mutex_lock(&auth_mutex);
+    *user_count = auth_user_count;
+    *override = admin_override;
+    pthread_mutex_unlock(&auth_mutex);
+}
+
 /**
  * @brief HC-06  Ʈ     óϴ  ԼԴϴ.
  */
 void* bluetoothThreadFunc(void* arg) {
     char read_buffer[1024];
+    char reply[200];
     int bytes_read;
     int authenticated = 0; // 0: α׾ƿ, 1: Ϲ , 2:  
 
@@ -89,6 +101,8 @@ void* bluetoothThreadFunc(void* arg) {
     write(uart_fd, welcome_msg, strlen(welcome_msg));
 
     while (1) {
+        watchdog_beat(HB_BLUETOOTH);
+
         // 1.  б
         memset(read_buffer, 0, sizeof(read_buffer));
         bytes_read = read(uart_fd, read_buffer, sizeof(read_buffer) - 1);
@@ -98,11 +112,16 @@ void* bluetoothThreadFunc(void* arg) {
             read_buffer[bytes_read] = '\0';
             read_buffer[strcspn(read_buffer, "\r\n")] = 0;
 
-            printf(">>> BT Received: %s (Len: %d)\n", read_buffer, bytes_read);
+            LOG1(LOG_BT_RECEIVED, bytes_read); // йȣ Ͽ  ʵ ̸ 
 
             // ---   ---
             if (authenticated == 0) {
-                if (strncmp(read_buffer, AUTH_PASSWORD, strlen(AUTH_PASSWORD)) == 0) {
+                const runtime_config_t* cfg = rcfg_acquire();
+                int is_user = strncmp(read_buffer, cfg->auth_password, strlen(cfg->auth_password)) == 0;
+                int is_admin = strncmp(read_buffer, cfg->admin_password, strlen(cfg->admin_password)) == 0;
+                rcfg_release(cfg); // UART      ʵ
+
+                if (is_user) {
                     authenticated = 1;
                     pthread_mutex_lock(&auth_mutex);
                     auth_user_count = 1; // Ϲ 
@@ -110,14 +129,14 @@ void* bluetoothThreadFunc(void* arg) {
 
                     const char* res = "Authentication successful. Motor unlocked. Send 'LOGOUT' to lock.\r\n";
                     write(uart_fd, res, strlen(res));
-                    printf(">>> BT: User authenticated (Normal).\n");
+                    LOG0(LOG_BT_AUTH_USER);
                 }
                 // ---   ---
-                else if (strncmp(read_buffer, ADMIN_PASSWORD, strlen(ADMIN_PASSWORD)) == 0) {
+                else if (is_admin) {
                     authenticated = 2; //  
-                    const char* res = "Administrator login successful. Send '1' (Open), '0' (Close) or 'LOGOUT'.\r\n";
+                    const char* res = "Administrator login successful. Send '1' (Open), '0' (Close), 'RELOAD', 'SET key value' or 'LOGOUT'.\r\n";
                     write(uart_fd, res, strlen(res));
-                    printf(">>> BT: User authenticated (Admin).\n");
+                    LOG0(LOG_BT_AUTH_ADMIN);
                 }
                 else {
                     const char* res = "Invalid password. Try again.\r\n";
@@ -125,6 +144,12 @@ void* bluetoothThreadFunc(void* arg) {
                 }
             }
 
+            // --- 2-1.    (RELOAD / SET key value) ---
+            else if (authenticated == 2 && rcfg_admin_command(read_buffer, "bt", reply, sizeof(reply) - 2)) {
+                strcat(reply, "\r\n");
+                write(uart_fd, reply, strlen(reply));
+            }
+
             // --- 2.   (Admin: 2) ---
             else if (authenticated == 2) {
                 pthread_mutex_lock(&auth_mutex);
@@ -146,7 +171,7 @@ void* bluetoothThreadFunc(void* arg) {
                     write(uart_fd, res, strlen(res));
                 }
                 else {
-                    const char* res = "Invalid admin command. Send '1', '0', or 'LOGOUT'.\r\n";
+                    const char* res = "Invalid admin command. Send '1', '0', 'RELOAD', 'SET key value' or 'LOGOUT'.\r\n";
                     write(uart_fd, res, strlen(res));
                 }
                 pthread_mutex_unlock(&auth_mutex);
@@ -169,7 +194,7 @@ void* bluetoothThreadFunc(void* arg) {
             }
         }
 
-        usleep(50000); // 50ms   ٽ б ()
+        clock_sleep_ms(50); // 50ms   ٽ б ()
     }
 
     close(uart_fd);
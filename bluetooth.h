@@ -5,5 +5,6 @@
 void init_bluetooth();
 void* bluetoothThreadFunc(void* arg);
 int is_motor_locked();
+void get_auth_state(int* user_count, int* override);
 
 #endif // BLUETOOTH_Hnce
@@ -0,0 +1,83 @@
+#include <stdio.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "boot.h"
+#include "clock.h"
+
+#define MAX_BOOT_PHASES 16
+
+typedef struct {
+    const char* name;
+    long start_us;
+    long end_us;
+} boot_phase_t;
+
+static long long boot_t0_us;             // main() 진입 시각 (clock_now_us)
+static double boot_uptime_at_start = 0;   // 전원 인가 후 main() 진입까지 걸린 시간 (s)
+static boot_phase_t phases[MAX_BOOT_PHASES];
+static int phase_count = 0;
+static pthread_mutex_t boot_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static volatile long detector_ready_us = -1; // 첫 감지 결과 수신 시각 (-1: 아직 없음)
+static volatile int armed_reported = 0;
+
+void boot_init() {
+    struct timespec up;
+    boot_t0_us = clock_now_us();
+
+    // CLOCK_BOOTTIME 은 서스펜드 시간까지 포함한 "전원 인가 후" 시간
+    clock_gettime(CLOCK_BOOTTIME, &up);
+    boot_uptime_at_start = up.tv_sec + up.tv_nsec / 1e9;
+}
+
+long boot_elapsed_us() {
+    return (long)(clock_now_us() - boot_t0_us);
+}
+
+void boot_record(const char* phase, long start_us, long end_us) {
+    pthread_mutex_lock(&boot_mutex);
+    if (phase_count < MAX_BOOT_PHASES) {
+        phases[phase_count].name = phase;
+        phases[phase_count].start_us = start_us;
+        phases[phase_count].end_us = end_us;
+        phase_count++;
+    }
+    pthread_mutex_unlock(&boot_mutex);
+}
+
+void boot_mark_detector_ready() {
+    pthread_mutex_lock(&boot_mutex);
+    if (detector_ready_us < 0) {
+        detector_ready_us = boot_elapsed_us();
+    }
+    pthread_mutex_unlock(&boot_mutex);
+}
+
+int boot_is_detector_ready() {
+    return detector_ready_us >= 0;
+}
+
+void boot_report_armed() {
+    if (armed_reported) return; // 메인 루프에서 매번 호출되므로 빠르게 빠져나감
+
+    long armed_us = boot_elapsed_us();
+
+    pthread_mutex_lock(&boot_mutex);
+    if (armed_reported) {
+        pthread_mutex_unlock(&boot_mutex);
+        return;
+    }
+    armed_reported = 1;
+
+    printf(">>> [Boot] ARMED at +%.1f ms (process start) / %.3f s since power-on\n",
+           armed_us / 1000.0, boot_uptime_at_start + armed_us / 1e6);
+    printf(">>> [Boot] %-16s %10s %10s %10s\n", "phase", "start(ms)", "end(ms)", "took(ms)");
+    for (int i = 0; i < phase_count; i++) {
+        printf(">>> [Boot] %-16s %10.1f %10.1f %10.1f\n", phases[i].name,
+               phases[i].start_us / 1000.0, phases[i].end_us / 1000.0,
+               (phases[i].end_us - phases[i].start_us) / 1000.0);
+    }
+    printf(">>> [Boot] %-16s %10s %10.1f\n", "first_detection", "-", detector_ready_us / 1000.0);
+    pthread_mutex_unlock(&boot_mutex);
+}
@@ -0,0 +1,16 @@
+#ifndef BOOT_H
+#define BOOT_H
+
+// 부팅(시작) 시간 계측 모듈
+// - main() 진입 시각을 기준(0)으로 각 초기화 단계의 시작/종료 시각을 기록
+// - 모든 모듈 초기화 + 첫 유효 감지 결과 수신 시점을 "ARMED" 로 보고
+
+void boot_init();                                        // main() 진입 직후 1회 호출
+long boot_elapsed_us();                                  // 기준 시각 이후 경과 시간 (us)
+void boot_record(const char* phase, long start_us, long end_us); // 단계별 소요 시간 기록
+
+void boot_mark_detector_ready(); // FIFO 로 첫 감지 결과가 들어왔을 때 호출 (여러 번 호출해도 첫 번째만 기록)
+int  boot_is_detector_ready();   // 첫 감지 결과 수신 여부
+void boot_report_armed();        // ARMED 시각과 단계별 내역 출력 (1회)
+
+#endif // BOOT_H
@@ -0,0 +1,340 @@
+import multiprocessing as mp
+import os
+import queue
+import signal
+import threading
+import time
+
+import cv2
+
+from blob_tracker import MIN_BLOB_AREA
+from evidence_store import EvidenceStore
+from motion_detector import MotionDetector, DEFAULT_THRESHOLD
+
+# 다중 카메라 감지 파이프라인
+# - 카메라마다 작업 프로세스 1개 (GIL 을 피하고, 코어 하나에 고정)
+# - 작업 프로세스는 프레임 차이(ROI + 다중 해상도, motion_detector.py) -> 덩어리 추적 -> 구역(zone) 매핑까지 하고
+#   결과(존재 구역 / 이번 프레임에 움직인 구역 비트마스크)만 큐로 보냄
+# - 부모 프로세스가 카메라별 결과를 구역별 상태로 합쳐서 C 쪽에 전달
+#
+# 카메라 설정 (dict):
+#   name          : 이름 (증거 사진 하위 폴더)
+#   source        : "picam:<번호>" 또는 "file:<동영상/이미지 폴더 경로>"
+#   core          : 고정할 CPU 코어 (None: 고정 안 함)
+#   threshold     : 프레임 차이 임계값
+#   min_blob_area : 이보다 작은 움직임 덩어리는 무시
+#                   (둘 다 실행 중 설정 파일의 detector_threshold / detector_min_blob_area 로 바꿀 수 있음,
+#                    "detector_threshold.<name>" 처럼 이름을 붙이면 해당 카메라만)
+#   zones         : [(구역 번호, 시작 x 비율, 끝 x 비율), ...] - 화면을 세로로 나눠 구역에 대응
+#                   추적 대상의 중심 x 가 속한 구역이 "존재" 로 표시됨
+#   roi           : [(구역 번호, [(x 비율, y 비율), ...]), ...] - 구역별 관심 영역 다각형 (있으면 zones 대신 사용)
+#                   ROI 밖의 움직임(하늘, 길거리 등)은 보지 않고, 추적 대상의 중심이 속한 다각형의 구역이 "존재"
+#   pyramid_levels: 축소 영상에서 먼저 변화를 찾을 단계 수 (기본 2, 0: 매 프레임 전체를 원래 해상도로)
+
+LORES_SIZE = (640, 480)
+STALE_FRAMES = 5        # 카메라 결과가 이만큼의 프레임 주기 동안 없으면 그 카메라의 구역 마스크를 버림
+STALE_MIN_S = 0.5       # (fps 제한 없음 / 높은 fps 에서도 최소 이 시간은 기다림)
+CHECK_INTERVAL_S = 0.5  # 작업 프로세스 생존 확인 주기 (다른 카메라 결과가 계속 와도 확인)
+
+
+class PicameraSource:
+    """Picamera2 스트림 (분석용 lores + 사진용 main 동시 구성)"""
+
+    def __init__(self, camera_num):
+        from picamera2 import Picamera2  # 파일 소스만 쓸 때(벤치마크)는 필요 없음
+        self.cam = Picamera2(camera_num)
+        config = self.cam.create_preview_configuration(
+            main={"size": (1920, 1080), "format": "BGR888"}, # 사진용 고화질
+            lores={"size": LORES_SIZE, "format": "YUV420"},  # 분석용 저화질
+            queue=False
+        )
+        self.cam.configure(config)
+        self.cam.start()
+
+    def read(self, want_main=False):
+        """(gray, main) 반환. want_main 이면 같은 요청(request)에서 사진용 프레임도 꺼냄"""
+        if not want_main:
+            return cv2.cvtColor(self.cam.capture_array("lores"), cv2.COLOR_YUV2GRAY_I420), None
+        request = self.cam.capture_request()
+        try:
+            lores = request.make_array("lores")
+            main = request.make_array("main")
+        finally:
+            request.release()
+        return cv2.cvtColor(lores, cv2.COLOR_YUV2GRAY_I420), main
+
+    def close(self):
+        self.cam.stop()
+
+
+class FileSource:
+    """동영상 파일 또는 이미지 폴더를 반복 재생 (시험/벤치마크용)
+    디코딩 비용이 감지 처리량에 섞이지 않도록 시작할 때 전부 읽어 둠"""
+
+    def __init__(self, path, max_frames=600):
+        self.frames = []
+        if os.path.isdir(path):
+            for name in sorted(os.listdir(path))[:max_frames]:
+                img = cv2.imread(os.path.join(path, name))
+                if img is not None:
+                    self._add(img)
+        else:
+            cap = cv2.VideoCapture(path)
+            while len(self.frames) < max_frames:
+                ok, img = cap.read()
+                if not ok:
+                    break
+                self._add(img)
+            cap.release()
+        if not self.frames:
+            raise RuntimeError(f"No frames in {path}")
+        self.pos = 0
+
+    def _add(self, bgr):
+        bgr = cv2.resize(bgr, LORES_SIZE, interpolation=cv2.INTER_AREA)
+        self.frames.append((cv2.cvtColor(bgr, cv2.COLOR_BGR2GRAY), bgr))
+
+    def read(self, want_main=False):
+        gray, bgr = self.frames[self.pos]
+        self.pos = (self.pos + 1) % len(self.frames)
+        return gray, (bgr if want_main else None)
+
+    def close(self):
+        pass
+
+
+def open_source(spec):
+    kind, _, arg = spec.partition(":")
+    if kind == "picam":
+        return PicameraSource(int(arg or 0))
+    if kind == "file":
+        return FileSource(arg)
+    raise ValueError(f"Unknown camera source: {spec}")
+
+
+def read_target_fps(path, last_mtime, fps):
+    """rate 파일이 바뀌었을 때만 다시 읽음 (매 프레임 stat 한 번)"""
+    try:
+        mtime = os.stat(path).st_mtime_ns
+    except OSError:
+        return last_mtime, fps
+    if mtime == last_mtime:
+        return last_mtime, fps
+    try:
+        with open(path) as f:
+            fps = max(1, int(f.read().strip()))
+    except (OSError, ValueError):
+        pass
+    return mtime, fps
+
+
+DETECTOR_KEYS = ("detector_threshold", "detector_min_blob_area")
+
+
+def read_detector_config(path, last_mtime, name):
+    """실행 중 설정 파일(C 와 공유)에서 이 카메라의 감지 값만 읽음
+    바뀌지 않았으면 (last_mtime, None), 바뀌었으면 (mtime, {키: 값})"""
+    try:
+        mtime = os.stat(path).st_mtime_ns
+    except OSError:
+        return last_mtime, None
+    if mtime == last_mtime:
+        return last_mtime, None
+    common, specific = {}, {}
+    try:
+        with open(path) as f:
+            for line in f:
+                key, eq, value = line.split("#", 1)[0].partition("=")
+                key, _, cam_name = key.strip().partition(".")
+                if not eq or key not in DETECTOR_KEYS or (cam_name and cam_name != name):
+                    continue
+                (specific if cam_name else common)[key] = int(value)
+    except (OSError, ValueError) as e:
+        # C 쪽과 마찬가지로 틀린 파일은 통째로 무시하고 이전 값 유지
+        print(f"[Python] {name}: config {path} ignored ({e})")
+        return mtime, None
+    common.update(specific)
+    return mtime, common
+
+
+def camera_worker(idx, cam, results, capture_incident, frames, busy_s, stop, rate_path, fps, evidence,
+                  config_path=None):
+    """카메라 1대 감지 루프 (작업 프로세스)
+    rate_path 가 있으면 C 의 Rate Governor 가 정한 fps 를 따름 (시작값 fps), 없으면 fps 고정 (0: 제한 없음)
+    config_path 가 있으면 바뀔 때마다 threshold / min_blob_area 를 다시 읽음"""
+    # Ctrl+C 는 부모가 처리하고 stop 으로 알려 줌
+    signal.signal(signal.SIGINT, signal.SIG_IGN)
+    wake = threading.Event()
+    signal.signal(signal.SIGUSR1, lambda signum, frame: wake.set())
+
+    if cam.get("core") is not None and hasattr(os, "sched_setaffinity"):
+        try:
+            os.sched_setaffinity(0, {cam["core"]})
+        except OSError as e:
+            print(f"[Python] {cam['name']}: cannot pin to core {cam['core']} ({e})")
+    cv2.setNumThreads(1)  # OpenCV 내부 쓰레드가 다른 카메라의 코어를 쓰지 않도록
+
+    source = open_source(cam["source"])
+    store = EvidenceStore(*evidence) if evidence else None
+    gray, _ = source.read()
+    detector = MotionDetector(cam, (gray.shape[1], gray.shape[0]))
+    detector.update(gray)
+    print(f"[Python] {cam['name']}: {cam['source']} running (pid {os.getpid()}, core {cam.get('core')})")
+    rate_mtime, target_fps = None, fps
+    config_mtime = None
+    try:
+        while not stop.is_set():
+            frame_start = time.monotonic()
+
+            # 실행 중 설정 변경 (매 프레임 stat 한 번, 바뀐 프레임부터 바로 적용)
+            if config_path:
+                first_load = config_mtime is None
+                config_mtime, settings = read_detector_config(config_path, config_mtime, cam["name"])
+                if settings is not None:
+                    detector.threshold = settings.get("detector_threshold", cam.get("threshold", DEFAULT_THRESHOLD))
+                    detector.tracker.min_blob_area = settings.get("detector_min_blob_area",
+                                                                  cam.get("min_blob_area", MIN_BLOB_AREA))
+                    if not first_load:
+                        delay_ms = (time.time_ns() - config_mtime) / 1e6
+                        print(f">>> [Python] {cam['name']}: config applied (threshold {detector.threshold}, "
+                              f"min blob {detector.tracker.min_blob_area}) {delay_ms:.1f} ms after change")
+
+            # 촬영 요청 (부모가 사건 번호를 넣어 둠)
+            incident = capture_incident[idx]
+            if incident and store is not None:
+                capture_incident[idx] = 0
+                gray, main = source.read(want_main=True)
+                if not store.submit(incident, main):
+                    print(f">>> [Python] {cam['name']}: capture dropped, writer busy (total dropped {store.dropped})")
+            else:
+                gray, _ = source.read()
+
+            mask = detector.update(gray)
+
+            results.put((idx, mask, detector.zone_mask(moving_only=True)))
+            frames[idx] += 1
+            busy_s[idx] += time.monotonic() - frame_start
+
+            # 목표 fps 에 맞춰 남은 시간만 대기 (SIGUSR1 이 오면 즉시 깨어남)
+            if rate_path:
+                rate_mtime, target_fps = read_target_fps(rate_path, rate_mtime, target_fps)
+            if target_fps:
+                remaining = 1.0 / target_fps - (time.monotonic() - frame_start)
+                if remaining > 0:
+                    wake.wait(remaining)
+                wake.clear()
+    finally:
+        source.close()
+        if store is not None:
+            store.close()
+            print(f"[Python] {cam['name']}: evidence saved {store.saved}, dropped {store.dropped}, evicted {store.evicted}, failed {store.failed}")
+
+
+class CameraPipeline:
+    def __init__(self, cameras, rate_path=None, default_fps=20, fixed_fps=None,
+                 evidence_dir=None, evidence_max_bytes=0, evidence_max_age_s=0, config_path=None):
+        """fixed_fps: None 이면 rate_path 를 따름 (처음엔 default_fps), 0 이면 제한 없음 (벤치마크)"""
+        # 작업 프로세스는 쓰레드를 만들기 전에 fork (부팅 시간 단축, spawn 은 모듈을 다시 import 함)
+        ctx = mp.get_context("fork")
+        n = len(cameras)
+        self.cameras = cameras
+        self.results = ctx.Queue(maxsize=64 * n)
+        self.capture_incident = ctx.Array("q", n)
+        self.frames = ctx.Array("q", n, lock=False)
+        self.busy_s = ctx.Array("d", n, lock=False)
+        self.stop_event = ctx.Event()
+        self.cam_masks = [0] * n
+        self.cam_seen = [None] * n  # 카메라별 마지막 결과 시각 (time.monotonic(), None: 아직 없음)
+        self.cam_stale = [False] * n
+        self.rate_path = rate_path if fixed_fps is None else None
+        self.rate_mtime = None
+        self.fps = default_fps if fixed_fps is None else fixed_fps
+        self.last_check = time.monotonic()
+
+        self.workers = []
+        for idx, cam in enumerate(cameras):
+            evidence = None
+            if evidence_dir:
+                # 카메라마다 하위 폴더, 용량 한도는 나눠 가짐
+                evidence = (os.path.join(evidence_dir, cam["name"]), evidence_max_bytes // n, evidence_max_age_s)
+            p = ctx.Process(target=camera_worker, name=f"cam-{cam['name']}",
+                            args=(idx, cam, self.results, self.capture_incident, self.frames, self.busy_s,
+                                  self.stop_event, rate_path if fixed_fps is None else None,
+                                  default_fps if fixed_fps is None else fixed_fps, evidence, config_path))
+            p.daemon = True
+            self.workers.append(p)
+
+    def start(self):
+        for p in self.workers:
+            p.start()
+
+    def next_result(self, timeout):
+        """카메라 결과 1개를 반영하고 (전체 구역 마스크, 이 카메라가 움직임을 본 구역, 카메라 번호) 반환
+        시간 초과면 None
+        다른 카메라 결과가 계속 와도 주기적으로 작업 프로세스 생존을 확인하고,
+        결과가 끊긴(멈춘) 카메라의 마지막 마스크는 합치지 않음 (존재가 계속 남지 않도록)"""
+        try:
+            idx, mask, motion = self.results.get(timeout=timeout)
+        except queue.Empty:
+            self.check_workers()
+            self.expire_stale(time.monotonic())
+            return None
+        now = time.monotonic()
+        self.cam_masks[idx] = mask
+        self.cam_seen[idx] = now
+        if self.cam_stale[idx]:
+            self.cam_stale[idx] = False
+            print(f">>> [Python] {self.cameras[idx]['name']}: results resumed")
+        if now - self.last_check >= CHECK_INTERVAL_S:
+            self.last_check = now
+            self.check_workers()
+        self.expire_stale(now)
+        merged = 0
+        for m in self.cam_masks:
+            merged |= m
+        return merged, motion, idx
+
+    def expire_stale(self, now):
+        if self.rate_path:
+            self.rate_mtime, self.fps = read_target_fps(self.rate_path, self.rate_mtime, self.fps)
+        stale_s = max(STALE_MIN_S, STALE_FRAMES / self.fps) if self.fps else STALE_MIN_S
+        for idx, seen in enumerate(self.cam_seen):
+            if seen is not None and not self.cam_stale[idx] and now - seen > stale_s:
+                self.cam_stale[idx] = True
+                self.cam_masks[idx] = 0
+                print(f">>> [Python] {self.cameras[idx]['name']}: no result for {now - seen:.1f} s, zones cleared")
+
+    def check_workers(self):
+        for p in self.workers:
+            if not p.is_alive():
+                raise RuntimeError(f"Camera worker {p.name} exited (code {p.exitcode})")
+
+    def request_capture(self, incident):
+        for idx in range(len(self.workers)):
+            self.capture_incident[idx] = incident
+
+    def wake(self):
+        """감지 주기가 올라갔을 때 대기 중인 작업 프로세스를 바로 깨움 (시그널 핸들러에서 호출 가능)"""
+        for p in self.workers:
+            if p.pid:
+                try:
+                    os.kill(p.pid, signal.SIGUSR1)
+                except OSError:
+                    pass
+
+    def stats(self):
+        return [(cam["name"], self.frames[i], self.busy_s[i]) for i, cam in enumerate(self.cameras)]
+
+    def stop(self):
+        self.stop_event.set()
+        # 큐를 비워야 작업 프로세스의 put 이 막히지 않고 종료됨
+        deadline = time.monotonic() + 3.0
+        while any(p.is_alive() for p in self.workers) and time.monotonic() < deadline:
+            try:
+                self.results.get(timeout=0.05)
+            except queue.Empty:
+                pass
+        for p in self.workers:
+            p.join(timeout=max(0.0, deadline - time.monotonic()))
+            if p.is_alive():
+                p.terminate()
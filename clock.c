@@ -0,0 +1,205 @@
+#include <stdio.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "clock.h"
+
+// 가상 시계에서 잠든 참가 쓰레드 (만료 시각, 잠든 순서로 정렬)
+typedef struct vsleeper {
+    long long due_ns;
+    unsigned long order;
+    const void* key;        // clock_cond_broadcast 로 깨울 조건 변수 (NULL: 없음)
+    int woken;              // broadcast 로 일찍 깨어남
+    int go;                 // 실행 차례가 옴
+    pthread_cond_t cv;
+    struct vsleeper* next;
+} vsleeper_t;
+
+static volatile int virtual_mode = 0;
+static long long vnow_ns = 0;
+static pthread_mutex_t vmutex = PTHREAD_MUTEX_INITIALIZER;
+static vsleeper_t* vqueue = NULL;
+static int vrunning = 0;        // 실행 중인 참가자 + 아직 clock_thread_begin() 전인 쓰레드
+static unsigned long vorder = 0;
+static unsigned long vjumps = 0;
+static __thread int vparticipant = 0; // 이 쓰레드가 가상 시계 참가자인지 (아니면 가상 모드에서도 실제 시간으로 대기)
+
+long long clock_now_ns() {
+    if (virtual_mode) return __atomic_load_n(&vnow_ns, __ATOMIC_ACQUIRE);
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (long long)t.tv_sec * 1000000000LL + t.tv_nsec;
+}
+
+long long clock_now_us() {
+    return clock_now_ns() / 1000;
+}
+
+long long clock_now_ms() {
+    return clock_now_ns() / 1000000;
+}
+
+// --- 가상 시계 ---
+
+static void vinsert_locked(vsleeper_t* s) {
+    vsleeper_t** p = &vqueue;
+    while (*p && ((*p)->due_ns < s->due_ns || ((*p)->due_ns == s->due_ns && (*p)->order < s->order))) {
+        p = &(*p)->next;
+    }
+    s->next = *p;
+    *p = s;
+}
+
+// 실행 중인 참가자가 없으면 가장 먼저 만료되는 쓰레드로 시간을 건너뛰고 실행 차례를 넘김
+static void vdispatch_locked() {
+    if (vrunning > 0 || vqueue == NULL) return;
+    vsleeper_t* s = vqueue;
+    vqueue = s->next;
+    if (s->due_ns > vnow_ns) {
+        __atomic_store_n(&vnow_ns, s->due_ns, __ATOMIC_RELEASE);
+        vjumps++;
+    }
+    s->go = 1;
+    vrunning++;
+    pthread_cond_signal(&s->cv);
+}
+
+// due_ns 까지 (또는 key 로 broadcast 될 때까지) 잠듦. broadcast 로 깨어나면 1
+static int vsleep_until(long long due_ns, const void* key) {
+    vsleeper_t self = { .key = key };
+    pthread_cond_init(&self.cv, NULL);
+
+    pthread_mutex_lock(&vmutex);
+    self.due_ns = due_ns > vnow_ns ? due_ns : vnow_ns;
+    self.order = vorder++;
+    vinsert_locked(&self);
+    vrunning--;
+    vdispatch_locked();
+    while (!self.go) {
+        pthread_cond_wait(&self.cv, &vmutex);
+    }
+    pthread_mutex_unlock(&vmutex);
+
+    pthread_cond_destroy(&self.cv);
+    return self.woken;
+}
+
+void clock_use_virtual(long long start_ns) {
+    pthread_mutex_lock(&vmutex);
+    vnow_ns = start_ns;
+    vrunning = 1; // 호출한 쓰레드
+    virtual_mode = 1;
+    vparticipant = 1;
+    pthread_mutex_unlock(&vmutex);
+}
+
+int clock_is_virtual() {
+    return virtual_mode;
+}
+
+void clock_thread_add() {
+    if (!virtual_mode) return;
+    pthread_mutex_lock(&vmutex);
+    vrunning++; // 새 쓰레드가 자리 잡기 전에 시간이 건너뛰지 않도록
+    pthread_mutex_unlock(&vmutex);
+}
+
+void clock_thread_begin() {
+    if (!virtual_mode) return;
+    vparticipant = 1;
+    vsleep_until(clock_now_ns(), NULL); // 지금 실행 중인 쓰레드가 잠들 때까지 대기
+}
+
+void clock_thread_end() {
+    if (!virtual_mode || !vparticipant) return;
+    vparticipant = 0;
+    pthread_mutex_lock(&vmutex);
+    vrunning--;
+    vdispatch_locked();
+    pthread_mutex_unlock(&vmutex);
+}
+
+unsigned long clock_virtual_jumps() {
+    return vjumps;
+}
+
+// --- 대기 ---
+
+// 참가하지 않은 쓰레드 (fd 를 기다리는 쓰레드 등) 는 가상 모드에서도 실제 시간으로 대기
+// (vsleep_until 을 부르면 vrunning 이 음수가 되어 시뮬레이션이 멈춤)
+static int vparticipating() {
+    return virtual_mode && vparticipant;
+}
+
+void clock_sleep_us(long us) {
+    if (vparticipating()) {
+        vsleep_until(clock_now_ns() + us * 1000LL, NULL);
+        return;
+    }
+    struct timespec t = { us / 1000000, (us % 1000000) * 1000L };
+    while (nanosleep(&t, &t) != 0 && errno == EINTR) {
+    }
+}
+
+void clock_sleep_ms(long ms) {
+    clock_sleep_us(ms * 1000L);
+}
+
+void clock_cond_init(pthread_cond_t* cond) {
+    // 대기 타임아웃은 시스템 시간 변경에 영향받지 않도록 MONOTONIC 기준
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+int clock_cond_timedwait(pthread_cond_t* cond, pthread_mutex_t* mutex, long long deadline_ns) {
+    if (vparticipating()) {
+        // 한 번에 한 참가자만 돌기 때문에, 락을 풀고 잠드는 사이에 broadcast 를 놓치지 않음
+        pthread_mutex_unlock(mutex);
+        int woken = vsleep_until(deadline_ns, cond);
+        pthread_mutex_lock(mutex);
+        return woken ? 0 : ETIMEDOUT;
+    }
+    if (virtual_mode) {
+        // 참가하지 않은 쓰레드: 가상 시각 기준 남은 시간을 실제 CLOCK_MONOTONIC 기한으로 바꿈
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        long long left = deadline_ns - clock_now_ns();
+        deadline_ns = (long long)now.tv_sec * 1000000000LL + now.tv_nsec + (left > 0 ? left : 0);
+    }
+    struct timespec t = { deadline_ns / 1000000000LL, deadline_ns % 1000000000LL };
+    return pthread_cond_timedwait(cond, mutex, &t);
+}
+
+void clock_cond_broadcast(pthread_cond_t* cond) {
+    pthread_cond_broadcast(cond); // 실제 시간으로 기다리는 쪽 (가상 모드에서는 참가하지 않은 쓰레드)
+    if (!virtual_mode) return;
+    // 이 조건 변수로 잠든 참가자를 "지금" 만료로 옮김 (부른 쓰레드가 잠든 뒤 실행)
+    pthread_mutex_lock(&vmutex);
+    vsleeper_t** p = &vqueue;
+    vsleeper_t* woken = NULL;
+    vsleeper_t** tail = &woken; // 잠든 순서 유지
+    while (*p) {
+        if ((*p)->key == cond) {
+            vsleeper_t* s = *p;
+            *p = s->next;
+            s->next = NULL;
+            *tail = s;
+            tail = &s->next;
+        } else {
+            p = &(*p)->next;
+        }
+    }
+    while (woken) {
+        vsleeper_t* s = woken;
+        woken = s->next;
+        s->due_ns = vnow_ns;
+        s->order = vorder++;
+        s->woken = 1;
+        vinsert_locked(s);
+    }
+    pthread_mutex_unlock(&vmutex);
+}
@@ -0,0 +1,42 @@
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <pthread.h>
+
+// 시계 추상화 (Clock)
+// - 모든 모듈은 대기/타이머/시각 기록에 delay(), millis(), usleep(), clock_gettime() 대신 이 함수를 사용
+// - 실제 시계: CLOCK_MONOTONIC + 실제 대기 (기본값)
+// - 가상 시계 (시뮬레이션): 이산 사건(discrete-event) 방식
+//   참가 쓰레드가 모두 clock_* 대기에 들어가면, 시간을 가장 먼저 만료되는 대기 시각으로 바로 건너뛰고
+//   그 쓰레드 하나만 실행 -> 한 번에 한 쓰레드만 돌기 때문에 몇 시간짜리 시나리오도 결정적으로 수 ms 안에 끝남
+//   (같은 시각에 만료되는 대기는 잠든 순서대로 실행)
+//
+// 가상 시계 사용 규칙
+// - 다른 쓰레드를 만들기 전에 clock_use_virtual() 호출 (호출한 쓰레드가 첫 참가자)
+// - 쓰레드를 만들기 직전에 clock_thread_add(), 새 쓰레드는 시작하자마자 clock_thread_begin(),
+//   끝날 때 clock_thread_end()
+// - 참가 쓰레드는 락을 잡은 채 clock_sleep_*() 하지 말 것 (다른 참가자가 그 락을 기다리면 멈춤)
+// - poll()/read() 처럼 파일 디스크립터를 기다리는 쓰레드는 참가시키지 않음
+//   참가하지 않은 쓰레드의 clock_sleep_*() / clock_cond_timedwait() 는 가상 모드에서도 실제 시간으로 대기
+//   (참가 여부는 쓰레드별로 기록: clock_use_virtual() 을 부른 쓰레드와 clock_thread_begin() ~ clock_thread_end() 사이)
+
+long long clock_now_ns();            // 단조 증가 시각 (CLOCK_MONOTONIC 또는 가상 시각)
+long long clock_now_us();
+long long clock_now_ms();
+void clock_sleep_ms(long ms);
+void clock_sleep_us(long us);
+
+// 조건 변수 대기 (deadline_ns 는 clock_now_ns() 기준 절대 시각)
+void clock_cond_init(pthread_cond_t* cond);                      // CLOCK_MONOTONIC 기준으로 초기화
+int  clock_cond_timedwait(pthread_cond_t* cond, pthread_mutex_t* mutex, long long deadline_ns); // 0 또는 ETIMEDOUT
+void clock_cond_broadcast(pthread_cond_t* cond);
+
+// 가상 시계
+void clock_use_virtual(long long start_ns);
+int  clock_is_virtual();
+void clock_thread_add();
+void clock_thread_begin();
+void clock_thread_end();
+unsigned long clock_virtual_jumps(); // 시간을 건너뛴 횟수 (처리한 사건 수)
+
+#endif // CLOCK_H
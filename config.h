@@ -11,6 +11,18 @@
 #define BUZZER_PIN  12  //  (SoftTone)
 #define SERVO_PIN   13  //   (SoftPWM) - * ߰*
 
+// ---   迭 (Ranging Scheduler) ---
+#define MAX_ZONES               4
+#define MAX_TRANSDUCERS         8
+// { Trig, Echo, (zone), ߻ ׷ }
+//  ׷ ÿ ߻ϹǷ  Ҹ  ʴ   
+#define RANGING_TRANSDUCERS     { { TRIG_PIN, ECHO_PIN, 0, 0 } }
+#define RANGING_HOLDOFF_US      10000 // ׷   Ҹ 
+#define RANGING_ECHO_TIMEOUT_US 25000 //  ִ  ( 4.2m)
+#define RANGING_STALE_MS        500   // ̺    Ÿ 
+#define RANGING_XTALK_CM        20.0  // ڱ ̸ŭ  ܵ ߻ Ȯ
+#define RANGING_XTALK_LIMIT     3     // ũνũ Ȯ Ƚ  ܵ ׷ и
+
 // --- ý   ---
 #define MODE_CLEAR   0
 #define MODE_SAFE    1  //  ( )
@@ -18,27 +30,75 @@
 #define MODE_DANGER  3  // ʱ (/)
 #define MODE_EXIT    99
 
+// ---      (runtime_config.c) ---
+// Ʒ ǥ(*)  ⺻̰,    Ͽ о  ߿ ٲ  
+#define RUNTIME_CONFIG_PATH "sentry.conf"
+
 // --- Ÿ Ӱ谪 (cm) ---
 #define DIST_WARN    100.0 // 1m ̳   
-#define DIST_DANGER  50.0  // 50cm ̳   
+#define DIST_DANGER  50.0  // (*) 50cm ̳   
+
+// --- PIR ---
+#define PIR_HOLD_MS  10000 // (*)     ð
 
 // --- Ʈũ    ---
 #define WIFI_SERVER_PORT 8080
-#define MAX_CLIENTS      5
-#define AUTH_PASSWORD    "1234"  // Ϲ  йȣ
-#define ADMIN_PASSWORD   "9999"  //  йȣ
+#define SHIPPED_MAX_CLIENTS 5    //   Ŭ̾Ʈ  (loadgen  Բ ǥ)
+#ifndef MAX_CLIENTS
+#define MAX_CLIENTS      SHIPPED_MAX_CLIENTS //   (loadgen) -DMAX_CLIENTS=...  ÷ 
+#endif
+#define WIFI_LISTEN_BACKLOG 64   // accept ⿭ (   SYN   )
+#define WIFI_CLIENT_SNDBUF  16384 // Ŭ̾Ʈ ۽   ( ʴ Ŭ̾Ʈ Ŀ ޸𸮸   ʵ)
+#define AUTH_PASSWORD    "1234"  // (*) Ϲ  йȣ
+#define ADMIN_PASSWORD   "9999"  // (*)  йȣ
+
+// --- UDP ƼĳƮ 溸 ä (LAN ü    ) ---
+#define ALERT_MCAST_ENABLE      1
+#define ALERT_MCAST_GROUP       "239.255.42.99"  //  (site-local) ׷
+#define ALERT_MCAST_PORT        8081
+#define ALERT_MCAST_IFACE       "0.0.0.0"        // ۽ ̽ ּ ( : "127.0.0.1")
+#define ALERT_MCAST_TTL         1                //  LAN   
+#define ALERT_UNIT_ID           1                // ġ ٸ 
+#define ALERT_REDUNDANCY        3                // Ŷ  溸 N Բ Ǿ  (ս )
+#define ALERT_HEARTBEAT_MS      1000             // 溸  ֽ ȣ ֱ 
+#define ALERT_HISTORY           64               // TCP "RESEND"  ٽ   ִ 溸 
 
 // --- ī޶  OpenCV  ---
-#define CAMERA_COMMAND "rpicam-still"
-#define CAPTURE_FILE_NAME "danger_capture.jpg"
-#define CAPTURE_OPTIONS " -o " CAPTURE_FILE_NAME " -t 1 --autofocus-mode auto"
+// Կ Python Detector   (  evidence/ Ʒ Ǻ  )
+#ifdef SIM_BUILD // ó ùķ̼:  ġ  ִ  ý / Python Detector  ġ ʵ
+#define TRIGGER_PATH        "/tmp/sentry_sim_trigger"
+#else
+#define TRIGGER_PATH        "/tmp/trigger_capture" // Կ û  (:  ȣ)
+#endif
+#define CAPTURE_INTERVAL_MS 1000                   // DANGER    Կ 
+
+// --- ̳ʸ α ---
+#define LOG_FILE_PATH       "/tmp/sentry.blog" // ./logdecode  ؽƮ ȯ
+#define LOG_ECHO_STDOUT     1                  // 1: 巹 尡 ֿܼ  (  )
 
 // === FIFO  (IPC) ===
 #define FIFO_PATH "/tmp/opencv_fifo" 
 
+// --- Python Detector ڵ  ( μ) ---
+#define PY_DETECTOR_PYTHON   "venv/bin/python3"   //  (sentry_system) ġ    ( ε )
+#define PY_DETECTOR_SCRIPT   "py_detector.py"
+#define PY_DETECTOR_LOG      "/tmp/py_log.txt"
+#define PY_RESTART_MIN_MS    200   //      (ּ)
+#define PY_RESTART_MAX_MS    5000  //   (ִ,    2辿 )
+#define PY_STABLE_RUN_MS     10000 //  ð ̻  ϸ   ʱȭ
+
+// ---  ֱ  (Rate Governor) ---
+#define GOV_IDLE_AFTER_MS    60000 //  Ȱ   ð  IDLE ( ֱ)
+#ifdef SIM_BUILD
+#define RATE_FILE_PATH       "/tmp/sentry_sim_rate"
+#else
+#define RATE_FILE_PATH       "/tmp/sentry_rate" // Python Detector  ӵ  
+#endif
+
 //    (extern)
 extern volatile int current_mode;
-extern volatile int opencv_motion_detected;
+extern volatile int opencv_motion_detected; // ī޶   (1:    ,  ־ )
+extern volatile unsigned int camera_zone_mask; //  ī޶   (bit n:  n,  ī޶ ջ)
 extern pthread_mutex_t mode_mutex;
 
 #endif // CONFIG_H
\ No newline at end of file
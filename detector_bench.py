@@ -0,0 +1,171 @@
+import argparse
+import os
+import time
+
+import cv2
+import numpy as np
+
+from blob_tracker import MISS_FRAMES
+from camera_pipeline import CameraPipeline, FileSource, LORES_SIZE
+from motion_detector import MotionDetector
+
+# 다중 카메라 감지 파이프라인 처리량 벤치마크 (카메라 없이 파일 소스 사용)
+# 사용법: python3 detector_bench.py [--video 파일] [--seconds 5] [--max-cameras 4]
+# - 카메라 수를 1 대부터 늘려 가며 제한 없는 fps 로 돌리고 전체/카메라별 처리량을 측정
+# - 카메라 i 는 사용 가능한 코어 중 (i % 코어 수) 번째에 고정 -> 코어 수까지는 거의 선형으로 늘어야 함
+# - --video 가 없으면 움직이는 사각형 + 잡음이 들어간 시험 영상을 만들어 사용
+#
+# ROI / 다중 해상도 비교: python3 detector_bench.py --roi [--passes 5]
+# - 문 앞 + 위쪽 길거리(차) + 오른쪽 나무(흔들림) 시험 영상을 한 프로세스에서 감지기만 돌려 비교
+#   (화면 전체 / ROI 만 / ROI + 다중 해상도)
+# - 프레임당 원래 해상도로 처리한 픽셀 수, 축소 영상 픽셀 수, ms/frame, 사람이 없을 때 울린 프레임(오탐),
+#   사람이 있을 때 잡은 비율을 출력
+
+SYNTH_PATH = "/tmp/sentry_bench.avi"
+STREET_PATH = "/tmp/sentry_bench_street.avi"
+STREET_FRAMES = 240
+PERSON_FRAMES = (80, 160)   # 이 구간에만 문 앞에 사람이 있음
+DOOR_ROI = [(0, [(0.30, 0.35), (0.70, 0.35), (0.85, 1.0), (0.15, 1.0)])]  # 문 앞 사다리꼴 (구역 0)
+
+
+def make_synthetic_video(path, frames=200):
+    w, h = LORES_SIZE
+    writer = cv2.VideoWriter(path, cv2.VideoWriter_fourcc(*"MJPG"), 20, (w, h))
+    rng = np.random.default_rng(0)
+    background = rng.integers(40, 80, (h, w, 3), dtype=np.uint8)
+    for i in range(frames):
+        frame = background.copy()
+        # 왼쪽 -> 오른쪽으로 걸어가다 가운데서 잠시 멈추는 사람 크기의 물체
+        x = min(40 + i * 4, w // 2) if i < frames // 2 else min(w // 2 + (i - frames // 2) * 4, w - 120)
+        cv2.rectangle(frame, (x, 120), (x + 80, 400), (200, 190, 180), -1)
+        noise = rng.integers(0, 6, (h, w, 3), dtype=np.uint8)
+        writer.write(cv2.add(frame, noise))
+    writer.release()
+
+
+def make_street_video(path, frames=STREET_FRAMES):
+    w, h = LORES_SIZE
+    writer = cv2.VideoWriter(path, cv2.VideoWriter_fourcc(*"MJPG"), 20, (w, h))
+    rng = np.random.default_rng(1)
+    background = rng.integers(40, 80, (h, w, 3), dtype=np.uint8)
+    background[:60] = (150, 140, 130)        # 하늘
+    background[60:150] = (70, 70, 70)        # 길거리
+    person = rng.integers(120, 230, (260, 80, 3), dtype=np.uint8)  # 옷 무늬 (몸 전체가 움직임으로 잡히도록)
+    for i in range(frames):
+        frame = background.copy()
+        # 길거리: 양방향으로 계속 지나가는 차 (ROI 밖)
+        for lane, speed, y in ((0, 9, 70), (1, -7, 110)):
+            x = (i * speed + lane * 300) % (w + 160) - 160
+            cv2.rectangle(frame, (x, y), (x + 140, y + 35), (30 + lane * 150, 60, 200), -1)
+        # 오른쪽 나무: 바람에 흔들리는 잎 (ROI 밖)
+        for _ in range(6):
+            cx, cy = int(rng.integers(560, 630)), int(rng.integers(170, 330))
+            cv2.circle(frame, (cx, cy), int(rng.integers(8, 20)), (40, 120 + int(rng.integers(0, 60)), 40), -1)
+        # 문 앞: 아래쪽에서 걸어와 문 앞에 잠시 섰다가 돌아감
+        if PERSON_FRAMES[0] <= i < PERSON_FRAMES[1]:
+            t = i - PERSON_FRAMES[0]
+            half = (PERSON_FRAMES[1] - PERSON_FRAMES[0]) // 2
+            y = 300 - min(t, half) * 3 if t < half else 300 - half * 3 + (t - half) * 3
+            frame[y:y + 260, 280:360] = person[:h - y]
+        noise = rng.integers(0, 6, (h, w, 3), dtype=np.uint8)
+        writer.write(cv2.add(frame, noise))
+    writer.release()
+
+
+def run_roi(passes):
+    """ROI / 다중 해상도 설정별로 같은 영상을 감지기에 직접 넣어 비교 (한 코어, 파이프라인 없이)"""
+    cv2.setNumThreads(1)
+    if not os.path.exists(STREET_PATH):
+        make_street_video(STREET_PATH)
+    source = FileSource(STREET_PATH)
+    frames = [gray for gray, _ in source.frames]
+    w, h = LORES_SIZE
+    modes = [("whole frame", {"zones": [(0, 0.0, 1.0)], "pyramid_levels": 0}),
+             ("roi", {"roi": DOOR_ROI, "pyramid_levels": 0}),
+             ("roi + pyramid", {"roi": DOOR_ROI})]
+
+    print(f"=== ROI / Pyramid Detector Benchmark ({len(frames)} frames x {passes} passes, source {STREET_PATH}) ===")
+    print(f"{'mode':>14} {'full px/frame':>14} {'coarse px/frame':>16} {'ms/frame':>9} {'false alarm':>12} {'detected':>9}")
+    base = None
+    for name, cfg in modes:
+        detector = MotionDetector(dict(cfg, threshold=25, min_blob_area=500), (w, h))
+        detector.update(frames[-1])
+        busy, false_alarm, absent, detected, present = 0.0, 0, 0, 0, 0
+        for _ in range(passes):
+            for i, gray in enumerate(frames):
+                t0 = time.perf_counter()
+                mask = detector.update(gray)
+                busy += time.perf_counter() - t0
+                if PERSON_FRAMES[0] <= i < PERSON_FRAMES[1]:
+                    present += 1
+                    detected += mask != 0
+                elif not (PERSON_FRAMES[1] <= i < PERSON_FRAMES[1] + MISS_FRAMES):  # 사람이 떠난 직후 유지 구간 제외
+                    absent += 1
+                    false_alarm += mask != 0
+        n = detector.frames
+        ms = busy * 1000 / (len(frames) * passes)
+        base = base or ms
+        print(f"{name:>14} {detector.pixels / n:>14.0f} {detector.coarse_pixels / n:>16.0f} {ms:>9.2f} "
+              f"{false_alarm:>5}/{absent:<6} {detected / max(1, present) * 100:>8.0f}%  (x{base / ms:.1f})")
+
+
+def run(n, video, seconds, cores):
+    cameras = [{"name": f"bench{i}", "source": f"file:{video}", "core": cores[i % len(cores)],
+                "threshold": 25, "min_blob_area": 500,
+                "zones": [(0, 0.0, 0.5), (1, 0.5, 1.0)]} for i in range(n)]
+    pipeline = CameraPipeline(cameras, fixed_fps=0)
+    pipeline.start()
+
+    # 부모는 실제 py_detector 처럼 결과를 합치기만 함 (FIFO 쓰기 대신)
+    # 작업 프로세스가 영상을 읽어 들일 때까지 기다렸다가 측정 시작
+    while any(frames == 0 for _, frames, _ in pipeline.stats()):
+        pipeline.next_result(timeout=5.0)
+    start_frames = [frames for _, frames, _ in pipeline.stats()]
+    t0 = time.monotonic()
+    zone_changes, last_mask = 0, 0
+    while time.monotonic() - t0 < seconds:
+        result = pipeline.next_result(timeout=1.0)
+        if result is not None and result[0] != last_mask:
+            zone_changes += 1
+            last_mask = result[0]
+    elapsed = time.monotonic() - t0
+    stats = pipeline.stats()
+    pipeline.stop()
+
+    per_cam = [(frames - f0) / elapsed for (_, frames, _), f0 in zip(stats, start_frames)]
+    ms_per_frame = [busy * 1000 / max(1, frames) for _, frames, busy in stats]
+    return sum(per_cam), per_cam, ms_per_frame, zone_changes
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--video", help="frame source (video file or image directory)")
+    parser.add_argument("--seconds", type=float, default=5.0)
+    cores = sorted(os.sched_getaffinity(0))
+    parser.add_argument("--max-cameras", type=int, default=len(cores))
+    parser.add_argument("--roi", action="store_true", help="compare whole-frame / ROI / ROI + pyramid detection")
+    parser.add_argument("--passes", type=int, default=5)
+    args = parser.parse_args()
+
+    if args.roi:
+        run_roi(args.passes)
+        return
+
+    video = args.video
+    if video is None:
+        video = SYNTH_PATH
+        if not os.path.exists(video):
+            make_synthetic_video(video)
+
+    print(f"=== Detector Pipeline Benchmark ({len(cores)} cores, source {video}) ===")
+    print(f"{'cams':>4} {'total fps':>10} {'per-cam fps':>12} {'ms/frame':>9} {'speedup':>8} {'efficiency':>10} {'zone changes':>12}")
+    base = None
+    for n in range(1, args.max_cameras + 1):
+        total, per_cam, ms, changes = run(n, video, args.seconds, cores)
+        base = base or total
+        speedup = total / base
+        print(f"{n:>4} {total:>10.1f} {sum(per_cam) / n:>12.1f} {sum(ms) / n:>9.2f} {speedup:>8.2f} {speedup / n * 100:>9.0f}% {changes:>12}")
+
+
+if __name__ == "__main__":
+    main()
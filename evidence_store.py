@@ -0,0 +1,217 @@
+import errno
+import os
+import queue
+import threading
+import time
+
+import cv2
+
+# 증거 사진 저장소 (백그라운드 기록)
+# - 감지 루프는 프레임을 큐에 넣기만 하고, JPEG 인코딩/썸네일/디스크 기록은 기록 쓰레드가 처리
+# - 사건(incident)별 폴더에 시각이 들어간 고유 파일명으로 저장 (덮어쓰기 없음)
+# - fsync 는 여러 장을 모아서 한 번에 (SD 카드 쓰기 횟수 절감)
+# - 용량/보관 기간을 넘으면 가장 오래된 사진부터 삭제
+
+JPEG_QUALITY = 90
+THUMB_WIDTH = 320
+
+
+class EvidenceStore:
+    def __init__(self, root, max_bytes, max_age_s, fsync_batch=8, fsync_interval_s=1.0, queue_size=16):
+        self.root = root
+        self.max_bytes = max_bytes
+        self.max_age_s = max_age_s
+        self.fsync_batch = fsync_batch
+        self.fsync_interval_s = fsync_interval_s
+
+        self.queue = queue.Queue(maxsize=queue_size)
+        self.dropped = 0     # 큐가 가득 차서 버린 프레임 수
+        self.saved = 0
+        self.evicted = 0
+        self.failed = 0      # 디스크 오류(ENOSPC/EIO 등)로 저장하지 못한 파일 수
+
+        self._pending = []   # fsync 대기 중인 (fd, 임시 경로, 최종 경로)
+        self._dirty_dirs = set()
+        self._last_flush = time.monotonic()
+        self._seq = 0
+
+        # 기존 파일 목록 (경로, 크기, mtime) - 오래된 순 (지난 실행이 남긴 *.tmp 는 지움)
+        os.makedirs(root, exist_ok=True)
+        self._files = self._scan()
+        self._total_bytes = sum(size for _, size, _ in self._files)
+
+        self._stop = False
+        self._thread = threading.Thread(target=self._writer_loop, name="evidence-writer", daemon=True)
+        self._thread.start()
+
+    # ----- 감지 루프에서 호출 (막히지 않음) -----
+
+    def submit(self, incident, frame):
+        """frame 은 BGR 배열. 큐가 가득 차면 버리고 개수만 기록"""
+        try:
+            self.queue.put_nowait((incident, time.time(), frame))
+            return True
+        except queue.Full:
+            self.dropped += 1
+            return False
+
+    def close(self):
+        self._stop = True
+        self._thread.join()
+
+    # ----- 기록 쓰레드 -----
+
+    def _scan(self):
+        files = []
+        for dirpath, _, names in os.walk(self.root):
+            for name in names:
+                path = os.path.join(dirpath, name)
+                if name.endswith(".tmp"):
+                    remove_quietly(path)  # fsync/rename 전에 꺼진 반쪽 파일
+                    continue
+                if not name.endswith(".jpg"):
+                    continue
+                try:
+                    st = os.stat(path)
+                except OSError:
+                    continue
+                files.append((path, st.st_size, st.st_mtime))
+        files.sort(key=lambda f: f[2])
+        return files
+
+    def _writer_loop(self):
+        while not (self._stop and self.queue.empty()):
+            try:
+                incident, ts, frame = self.queue.get(timeout=self.fsync_interval_s)
+            except queue.Empty:
+                self._safe_flush()
+                continue
+
+            try:
+                self._write(incident, ts, frame)
+            except Exception as e:
+                print(f">>> [Evidence] Write failed: {e}")
+
+            # 배치가 찼거나, 시간이 지났거나, 더 기다리는 프레임이 없으면 fsync
+            if (len(self._pending) >= self.fsync_batch
+                    or time.monotonic() - self._last_flush >= self.fsync_interval_s
+                    or self.queue.empty()):
+                self._safe_flush()
+        self._safe_flush()
+
+    def _write(self, incident, ts, frame):
+        incident_dir = os.path.join(self.root, "incident_" + time.strftime("%Y%m%d-%H%M%S", time.localtime(incident)))
+        os.makedirs(incident_dir, exist_ok=True)
+
+        self._seq += 1
+        stamp = time.strftime("%Y%m%d-%H%M%S", time.localtime(ts)) + f".{int(ts * 1000) % 1000:03d}"
+        base = f"{stamp}_{self._seq:05d}"
+
+        ok, jpg = cv2.imencode(".jpg", frame, [cv2.IMWRITE_JPEG_QUALITY, JPEG_QUALITY])
+        if not ok:
+            raise RuntimeError("JPEG encode failed")
+
+        h, w = frame.shape[:2]
+        thumb = cv2.resize(frame, (THUMB_WIDTH, THUMB_WIDTH * h // w), interpolation=cv2.INTER_AREA)
+        ok, thumb_jpg = cv2.imencode(".jpg", thumb, [cv2.IMWRITE_JPEG_QUALITY, 80])
+        if not ok:
+            raise RuntimeError("Thumbnail encode failed")
+
+        for suffix, data in ((".jpg", jpg), (".thumb.jpg", thumb_jpg)):
+            final = os.path.join(incident_dir, base + suffix)
+            tmp = final + ".tmp"
+            fd = os.open(tmp, os.O_WRONLY | os.O_CREAT | os.O_TRUNC, 0o666)
+            try:
+                write_all(fd, data.tobytes())
+            except OSError:
+                os.close(fd)
+                remove_quietly(tmp)
+                raise
+            self._pending.append((fd, tmp, final))
+            self._total_bytes += len(data)
+            self._files.append((final, len(data), ts))
+        self._dirty_dirs.add(incident_dir)
+        self.saved += 1
+
+    def _safe_flush(self):
+        # SD 카드 오류 하나로 기록 쓰레드가 죽으면 이후 사진이 모두 큐에만 쌓이므로 여기서 잡음
+        try:
+            self._flush()
+        except Exception as e:
+            print(f">>> [Evidence] Flush failed: {e}")
+
+    def _flush(self):
+        if self._pending:
+            # 데이터 fsync -> 이름 확정(rename) -> 폴더 fsync 순서로 해야 전원이 나가도 반쪽 파일이 남지 않음
+            failed = set()
+            for fd, tmp, final in self._pending:
+                try:
+                    os.fsync(fd)
+                    os.close(fd)
+                    fd = -1
+                    os.rename(tmp, final)
+                    os.chmod(final, 0o666)
+                except OSError as e:
+                    print(f">>> [Evidence] Write failed ({final}): {e}")
+                    if fd >= 0:
+                        os.close(fd)
+                    remove_quietly(tmp)
+                    failed.add(final)
+            self._pending = []
+            if failed:
+                self.failed += len(failed)
+                self.saved -= sum(1 for path in failed if not path.endswith(".thumb.jpg"))
+                self._total_bytes -= sum(size for path, size, _ in self._files if path in failed)
+                self._files = [f for f in self._files if f[0] not in failed]
+            for d in self._dirty_dirs | {self.root}:
+                try:
+                    fsync_dir(d)
+                except OSError as e:
+                    print(f">>> [Evidence] Directory fsync failed ({d}): {e}")
+            self._dirty_dirs.clear()
+        self._last_flush = time.monotonic()
+        self._enforce_quota()
+
+    def _enforce_quota(self):
+        now = time.time()
+        while self._files and (self._total_bytes > self.max_bytes or now - self._files[0][2] > self.max_age_s):
+            path, size, _ = self._files.pop(0)
+            try:
+                os.remove(path)
+                self.evicted += 1
+            except OSError:
+                pass
+            self._total_bytes -= size
+
+            # 빈 사건 폴더 정리
+            d = os.path.dirname(path)
+            if d != self.root:
+                try:
+                    os.rmdir(d)
+                except OSError:
+                    pass
+
+
+def write_all(fd, data):
+    """짧은 쓰기(SD 카드가 거의 찼을 때 등)를 이어서 끝까지 씀, 더 쓸 수 없으면 OSError"""
+    view = memoryview(data)
+    while view:
+        n = os.write(fd, view)
+        if n <= 0:
+            raise OSError(errno.ENOSPC, "short write")
+        view = view[n:]
+
+
+def remove_quietly(path):
+    try:
+        os.remove(path)
+    except OSError:
+        pass
+
+
+def fsync_dir(path):
+    fd = os.open(path, os.O_RDONLY)
+    try:
+        os.fsync(fd)
+    finally:
+        os.close(fd)
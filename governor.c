@@ -0,0 +1,166 @@
+#include <stdio.h>
+#include <time.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/resource.h>
+
+#include "config.h"
+#include "governor.h"
+#include "boot.h"
+#include "sensors.h"
+#include "log.h"
+#include "runtime_config.h"
+#include "clock.h"
+
+// 수준별 주기 표는 실행 중 설정(runtime_config.c)에 있음
+static const char* level_names[RATE_LEVELS] = { "IDLE", "NORMAL", "ACTIVE" };
+
+static pthread_mutex_t gov_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t gov_cond;
+static volatile int level = RATE_ACTIVE; // 부팅 직후는 빠르게 시작
+static long last_activity_us = 0;
+static unsigned long wake_epoch = 0; // 설정 교체 시 증가 (잠든 쓰레드 깨우기)
+static int rate_pending = 0;         // Detector 에 아직 알리지 않은 프레임 속도 변경 (메인 쓰레드가 락 밖에서 기록)
+
+// 수준별 통계
+static long level_enter_us;
+static double level_enter_cpu;
+static double wall_s[RATE_LEVELS];
+static double cpu_s[RATE_LEVELS];
+static unsigned long wakeups[RATE_LEVELS];
+
+static double process_cpu_s() {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1e6
+         + ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1e6;
+}
+
+// Python Detector 에 프레임 속도 전달 (임시 파일 작성 후 rename 으로 원자적 교체)
+// SD 카드 쓰기 + kill 이므로 gov_mutex 밖에서만 호출 (PIR 인터럽트 / 다른 쓰레드가 기다리지 않도록)
+static void publish_detector_rate(int fps) {
+    FILE* fp = fopen(RATE_FILE_PATH ".tmp", "w");
+    if (fp == NULL) return;
+    fprintf(fp, "%d\n", fps);
+    fclose(fp);
+    rename(RATE_FILE_PATH ".tmp", RATE_FILE_PATH);
+    notify_python_detector(); // 대기 중인 Detector 를 바로 깨움
+}
+
+// 밀린 프레임 속도 변경이 있으면 기록 (메인 쓰레드, gov_mutex 밖)
+static void flush_detector_rate() {
+    pthread_mutex_lock(&gov_mutex);
+    int pending = rate_pending;
+    rate_pending = 0;
+    int fps = rcfg_rate(level, GOV_DETECTOR_FPS);
+    pthread_mutex_unlock(&gov_mutex);
+
+    if (pending) publish_detector_rate(fps);
+}
+
+// gov_mutex 를 잡은 상태에서 호출 (수준만 바꾸고, 파일 기록은 flush_detector_rate 로 미룸)
+static void set_level_locked(int new_level) {
+    if (new_level == level) return;
+
+    long now = boot_elapsed_us();
+    double cpu = process_cpu_s();
+    wall_s[level] += (now - level_enter_us) / 1e6;
+    cpu_s[level] += cpu - level_enter_cpu;
+    level_enter_us = now;
+    level_enter_cpu = cpu;
+
+    int raised = new_level > level;
+    level = new_level;
+    LOG1(LOG_RATE_LEVEL, level_names[new_level]);
+
+    rate_pending = 1;
+    if (raised) {
+        clock_cond_broadcast(&gov_cond); // 느린 주기로 자고 있는 쓰레드들(메인 루프 포함)을 즉시 깨움
+    }
+}
+
+void init_governor() {
+    clock_cond_init(&gov_cond);
+
+    level_enter_us = boot_elapsed_us();
+    level_enter_cpu = process_cpu_s();
+    last_activity_us = level_enter_us;
+    publish_detector_rate(rcfg_rate(level, GOV_DETECTOR_FPS));
+}
+
+void governor_update(int mode, int pir_detected) {
+    long now = boot_elapsed_us();
+
+    pthread_mutex_lock(&gov_mutex);
+    if (pir_detected || mode == MODE_WARN || mode == MODE_DANGER) {
+        last_activity_us = now;
+        set_level_locked(RATE_ACTIVE);
+    }
+    else if ((now - last_activity_us) / 1000 < GOV_IDLE_AFTER_MS) {
+        set_level_locked(RATE_NORMAL);
+    }
+    else {
+        set_level_locked(RATE_IDLE);
+    }
+    pthread_mutex_unlock(&gov_mutex);
+
+    // 이번 호출이나 PIR 인터럽트 / 설정 교체가 바꾼 프레임 속도를 락 밖에서 전달
+    flush_detector_rate();
+}
+
+void governor_on_pir_edge() {
+    pthread_mutex_lock(&gov_mutex);
+    last_activity_us = boot_elapsed_us();
+    set_level_locked(RATE_ACTIVE);
+    pthread_mutex_unlock(&gov_mutex);
+}
+
+int governor_level() {
+    return level;
+}
+
+int governor_period_ms(int role) {
+    return rcfg_rate(level, role);
+}
+
+void governor_sleep_ms(int ms) {
+    long long deadline = clock_now_ns() + ms * 1000000LL;
+
+    pthread_mutex_lock(&gov_mutex);
+    int start_level = level;
+    unsigned long start_epoch = wake_epoch;
+    // 수준이 올라가거나(broadcast) 설정이 바뀌면 남은 시간과 관계없이 깨어남
+    while (level <= start_level && wake_epoch == start_epoch) {
+        if (clock_cond_timedwait(&gov_cond, &gov_mutex, deadline) == ETIMEDOUT) break;
+    }
+    wakeups[level]++;
+    pthread_mutex_unlock(&gov_mutex);
+}
+
+void governor_config_changed() {
+    pthread_mutex_lock(&gov_mutex);
+    wake_epoch++;
+    rate_pending = 1; // 메인 루프가 깨어나서 다음 governor_update 에서 기록
+    clock_cond_broadcast(&gov_cond);
+    pthread_mutex_unlock(&gov_mutex);
+}
+
+void governor_report() {
+    pthread_mutex_lock(&gov_mutex);
+    // 현재 수준에 머문 시간까지 반영한 사본으로 계산
+    double w[RATE_LEVELS], c[RATE_LEVELS];
+    for (int i = 0; i < RATE_LEVELS; i++) {
+        w[i] = wall_s[i];
+        c[i] = cpu_s[i];
+    }
+    w[level] += (boot_elapsed_us() - level_enter_us) / 1e6;
+    c[level] += process_cpu_s() - level_enter_cpu;
+
+    printf(">>> [Governor] %-7s %10s %8s %12s\n", "level", "time(s)", "cpu(%)", "wakeups/s");
+    for (int i = 0; i < RATE_LEVELS; i++) {
+        printf(">>> [Governor] %-7s %10.1f %8.2f %12.1f\n", level_names[i], w[i],
+               w[i] > 0 ? c[i] / w[i] * 100.0 : 0.0,
+               w[i] > 0 ? wakeups[i] / w[i] : 0.0);
+    }
+    pthread_mutex_unlock(&gov_mutex);
+}
@@ -0,0 +1,29 @@
+#ifndef GOVERNOR_H
+#define GOVERNOR_H
+
+// 위협 수준에 따른 감지 주기 조절 (Rate Governor)
+// - IDLE  : 오랫동안 아무 일도 없는 SAFE -> 가장 느린 주기 (전력 절감)
+// - NORMAL: 최근 활동이 있었던 SAFE
+// - ACTIVE: PIR 감지 중 또는 WARN/DANGER -> 가장 빠른 주기
+// PIR 상승 에지가 들어오면 즉시 ACTIVE 로 올리고 잠든 쓰레드들을 깨웁니다.
+
+enum { RATE_IDLE = 0, RATE_NORMAL, RATE_ACTIVE, RATE_LEVELS };
+
+enum {
+    GOV_MAIN_LOOP = 0, // 메인 루프 (PIR/초음파 샘플링)
+    GOV_DISPLAY,       // 닷매트릭스 갱신
+    GOV_BUZZER,        // 부저 쓰레드 대기 (SAFE 일 때)
+    GOV_DETECTOR_FPS,  // Python Detector 프레임 속도
+    GOV_ROLES
+};
+
+void init_governor();
+void governor_update(int mode, int pir_detected); // 메인 루프에서 매번 호출 (바뀐 Detector 프레임 속도도 여기서 기록)
+void governor_on_pir_edge();                      // PIR 인터럽트에서 호출 (즉시 ACTIVE)
+int  governor_level();
+int  governor_period_ms(int role);                // 현재 수준에서의 주기 (DETECTOR_FPS 는 fps)
+void governor_sleep_ms(int ms);                   // 수준이 올라가면 일찍 깨어나는 대기
+void governor_report();                           // 수준별 평균 CPU / 초당 wakeup 출력
+void governor_config_changed();                   // 설정 교체 시: 새 주기 즉시 적용 (rcfg_on_change 로 등록)
+
+#endif // GOVERNOR_H
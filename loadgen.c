@@ -0,0 +1,388 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+
+#include "config.h"
+#include "network.h"
+
+// =========================================================
+// 경보 서버 부하 시험 도구 (구독자 부하 생성 + 전달 지연 측정)
+// =========================================================
+// 사용법: ./loadgen [-f 빠른 클라이언트 수] [-s 느린] [-S 멈춘] [-c 접속/해제 반복]
+//                   [-b 버스트 수] [-k 버스트당 경보 수] [-g 버스트 간격 ms] [-a 경보 간격 us]
+//                   [-r 느린 클라이언트 읽기 속도 B/s] [-w 접속 후 대기 ms]
+//
+// - 자식 프로세스에서 network.c 를 그대로 실행하고 WARN/DANGER 경보를 버스트로 보냅니다.
+//   (send_alert 호출 직전 시각을 공유 메모리에 기록)
+// - 부모 프로세스가 구독자 연결을 열고, 받은 경보마다 (수신 시각 - 송신 시각) 을 기록합니다.
+//   TCP 경보 문자열은 모두 '[' 로 시작하므로 '[' 개수로 몇 번째 경보인지 셉니다.
+// - 끝나면 클라이언트 종류별 지연 백분위수, send_alert() 소요 시간, 서버 CPU/메모리를 출력합니다.
+// 빌드: make loadgen (network.c 를 LOADGEN_MAX_CLIENTS 슬롯으로 다시 컴파일)
+//       make loadgen_shipped (배포 빌드와 같은 MAX_CLIENTS - 슬롯을 넘는 구독자는 rejected 로 집계)
+// 결과 머리말에 측정한 서버의 MAX_CLIENTS 와 배포 빌드 값을 같이 출력
+
+#define LOADGEN_MAX_ALERTS 100000
+#define TICK_MS            10
+
+enum { CLS_FAST, CLS_SLOW, CLS_STALLED, CLS_CHURN, CLS_COUNT };
+static const char* cls_names[CLS_COUNT] = { "fast", "slow", "stalled", "churn" };
+
+typedef struct {
+    int fd;
+    int cls;
+    long received;     // 받은 경보 수 ('[' 개수)
+    long delivered;    // 시험 시간 안에 읽은 경보 수
+    int closed;        // 서버가 연결을 끊음 (EOF)
+    double budget;     // 느린 클라이언트: 이번에 읽을 수 있는 바이트
+    long long next_ns; // 접속/해제 반복: 다음 재접속 시각
+} sub_t;
+
+// 자식(서버) <-> 부모(구독자) 공유 메모리
+typedef struct {
+    int ready;
+    int go;
+    int done;
+    int sent;
+    long long send_ns[LOADGEN_MAX_ALERTS];   // send_alert 호출 직전 (CLOCK_MONOTONIC)
+    long long fanout_ns[LOADGEN_MAX_ALERTS]; // send_alert 소요 시간
+} shared_t;
+
+typedef struct {
+    long long* v;
+    long n, cap;
+} samples_t;
+
+static shared_t* shm;
+static sub_t* subs;
+static int sub_count = 0;
+static samples_t lat[CLS_COUNT];
+static long churn_connects = 0, churn_refused = 0;
+
+// network.c 가 부르는 하트비트 (감시 쓰레드 없이 실행하므로 빈 함수)
+void watchdog_beat(int id) {
+}
+
+static long long now_ns() {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (long long)t.tv_sec * 1000000000LL + t.tv_nsec;
+}
+
+static void add_sample(samples_t* s, long long v) {
+    if (s->n == s->cap) {
+        s->cap = s->cap ? s->cap * 2 : 4096;
+        s->v = realloc(s->v, s->cap * sizeof(long long));
+    }
+    s->v[s->n++] = v;
+}
+
+static int cmp_ll(const void* a, const void* b) {
+    long long x = *(const long long*)a, y = *(const long long*)b;
+    return (x > y) - (x < y);
+}
+
+static double pct_ms(long long* sorted, long n, double p) {
+    if (n == 0) return 0;
+    long i = (long)(p / 100.0 * (n - 1) + 0.5);
+    return sorted[i] / 1e6;
+}
+
+// ----- 서버 (자식 프로세스) -----
+
+static void run_server(int bursts, int per_burst, int burst_gap_ms, int alert_gap_us) {
+    pthread_t th;
+    init_network();
+    pthread_create(&th, NULL, wifiServerThreadFunc, NULL);
+    __atomic_store_n(&shm->ready, 1, __ATOMIC_RELEASE);
+
+    while (!__atomic_load_n(&shm->go, __ATOMIC_ACQUIRE)) usleep(1000);
+
+    int n = 0;
+    for (int b = 0; b < bursts; b++) {
+        for (int k = 0; k < per_burst; k++, n++) {
+            long long t0 = now_ns();
+            shm->send_ns[n] = t0;
+            __atomic_store_n(&shm->sent, n + 1, __ATOMIC_RELEASE);
+            send_alert((n % 2) ? MODE_WARN : MODE_DANGER);
+            shm->fanout_ns[n] = now_ns() - t0;
+            if (alert_gap_us > 0) usleep(alert_gap_us);
+        }
+        usleep(burst_gap_ms * 1000);
+    }
+    __atomic_store_n(&shm->done, 1, __ATOMIC_RELEASE);
+    while (1) pause();
+}
+
+// ----- 구독자 (부모 프로세스) -----
+
+static int connect_sub(int cls) {
+    struct sockaddr_in addr = { .sin_family = AF_INET, .sin_port = htons(WIFI_SERVER_PORT) };
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (cls == CLS_SLOW || cls == CLS_STALLED) {
+        int rcvbuf = 4096; // 작은 수신 창 -> 서버 송신 버퍼가 빨리 참
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    }
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// 읽을 수 있는 만큼 (max 바이트까지) 읽고 경보 수를 셈. 반환: 읽은 바이트
+static long read_sub(sub_t* c, long max, int record) {
+    char buf[65536];
+    long total = 0;
+
+    while (!c->closed && total < max) {
+        long want = max - total < (long)sizeof(buf) ? max - total : (long)sizeof(buf);
+        ssize_t n = recv(c->fd, buf, want, MSG_DONTWAIT);
+        if (n == 0) {
+            c->closed = 1;
+            break;
+        }
+        if (n < 0) break;
+
+        long long t = now_ns();
+        int sent = __atomic_load_n(&shm->sent, __ATOMIC_ACQUIRE);
+        for (ssize_t i = 0; i < n; i++) {
+            if (buf[i] != '[') continue;
+            long idx = c->received++;
+            if (record && idx < sent) add_sample(&lat[c->cls], t - shm->send_ns[idx]);
+        }
+        total += n;
+    }
+    return total;
+}
+
+static void churn_tick(sub_t* c, long long t) {
+    if (t < c->next_ns) return;
+    if (c->fd >= 0) close(c->fd);
+    c->fd = connect_sub(CLS_CHURN);
+    churn_connects++;
+    if (c->fd < 0) churn_refused++;
+    c->next_ns = t + (rand() % 200 + 10) * 1000000LL; // 10~210ms 유지 후 재접속
+}
+
+// /proc 에서 서버 CPU 시간(초) / 메모리(kB) 읽기
+static double proc_cpu_s(pid_t pid) {
+    char path[64];
+    unsigned long ut = 0, st = 0;
+    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+    FILE* fp = fopen(path, "r");
+    if (fp == NULL) return 0;
+    // pid (comm) state ... 14번째: utime, 15번째: stime
+    if (fscanf(fp, "%*d %*s %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu", &ut, &st) != 2) ut = st = 0;
+    fclose(fp);
+    return (double)(ut + st) / sysconf(_SC_CLK_TCK);
+}
+
+static long proc_status_kb(pid_t pid, const char* key) {
+    char path[64], line[128];
+    long kb = 0;
+    snprintf(path, sizeof(path), "/proc/%d/status", pid);
+    FILE* fp = fopen(path, "r");
+    if (fp == NULL) return 0;
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        if (strncmp(line, key, strlen(key)) == 0) sscanf(line + strlen(key), ":%ld", &kb);
+    }
+    fclose(fp);
+    return kb;
+}
+
+int main(int argc, char* argv[]) {
+    int counts[CLS_COUNT] = { 1000, 100, 10, 20 };
+    int bursts = 20, per_burst = 100, burst_gap_ms = 200, alert_gap_us = 0;
+    int slow_rate = 2000, settle_ms = 1000;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) break;
+        if (strcmp(argv[i], "-f") == 0) counts[CLS_FAST] = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-s") == 0) counts[CLS_SLOW] = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-S") == 0) counts[CLS_STALLED] = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-c") == 0) counts[CLS_CHURN] = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-b") == 0) bursts = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-k") == 0) per_burst = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-g") == 0) burst_gap_ms = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-a") == 0) alert_gap_us = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-r") == 0) slow_rate = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-w") == 0) settle_ms = atoi(argv[++i]);
+    }
+    long total_alerts = (long)bursts * per_burst;
+    if (total_alerts > LOADGEN_MAX_ALERTS) {
+        fprintf(stderr, "Too many alerts (max %d)\n", LOADGEN_MAX_ALERTS);
+        return 1;
+    }
+
+    // 구독자 수천 개 + 서버 쪽 소켓 -> 파일 디스크립터 한도를 최대로
+    struct rlimit rl;
+    getrlimit(RLIMIT_NOFILE, &rl);
+    rl.rlim_cur = rl.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &rl);
+    signal(SIGPIPE, SIG_IGN);
+
+    shm = mmap(NULL, sizeof(shared_t), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shm == MAP_FAILED) {
+        perror("[loadgen] mmap failed");
+        return 1;
+    }
+    memset(shm, 0, sizeof(*shm));
+
+    pid_t server = fork();
+    if (server == 0) {
+        run_server(bursts, per_burst, burst_gap_ms, alert_gap_us);
+        _exit(0);
+    }
+    while (!__atomic_load_n(&shm->ready, __ATOMIC_ACQUIRE)) usleep(1000);
+
+    // 구독자 접속
+    int total_subs = counts[CLS_FAST] + counts[CLS_SLOW] + counts[CLS_STALLED] + counts[CLS_CHURN];
+    subs = calloc(total_subs, sizeof(sub_t));
+    int epfd = epoll_create1(0);
+    int connect_fail = 0;
+    for (int cls = 0; cls < CLS_COUNT; cls++) {
+        for (int i = 0; i < counts[cls]; i++) {
+            sub_t* c = &subs[sub_count];
+            c->cls = cls;
+            c->fd = connect_sub(cls);
+            if (c->fd < 0) {
+                connect_fail++;
+                c->closed = 1;
+            }
+            if (c->fd >= 0 && cls == CLS_FAST) {
+                struct epoll_event ev = { .events = EPOLLIN, .data.u32 = sub_count };
+                epoll_ctl(epfd, EPOLL_CTL_ADD, c->fd, &ev);
+            }
+            sub_count++;
+        }
+    }
+    printf(">>> [loadgen] %d subscribers connected (%d failed), server MAX_CLIENTS=%d\n",
+           sub_count - connect_fail, connect_fail, MAX_CLIENTS);
+    usleep(settle_ms * 1000); // 서버가 accept 를 마칠 때까지
+
+    // 시작 전에 서버가 끊은 연결 (슬롯 부족) 확인
+    int rejected[CLS_COUNT] = { 0 };
+    for (int i = 0; i < sub_count; i++) {
+        if (subs[i].cls != CLS_CHURN && !subs[i].closed) {
+            read_sub(&subs[i], 1, 0);
+            if (subs[i].closed) rejected[subs[i].cls]++;
+        }
+    }
+
+    double cpu0 = proc_cpu_s(server);
+    long long t_start = now_ns();
+    __atomic_store_n(&shm->go, 1, __ATOMIC_RELEASE);
+
+    // 메인 루프: 빠른 클라이언트는 epoll 로 즉시, 느린 클라이언트는 TICK_MS 마다 속도 제한, 멈춘 클라이언트는 읽지 않음
+    struct epoll_event events[256];
+    long long next_tick = now_ns();
+    long long done_ns = 0;
+    double cpu1 = 0;
+    long rss_kb = 0, hwm_kb = 0;
+    while (1) {
+        int n = epoll_wait(epfd, events, 256, 1);
+        for (int e = 0; e < n; e++) {
+            sub_t* c = &subs[events[e].data.u32];
+            read_sub(c, 1L << 30, 1);
+            if (c->closed) epoll_ctl(epfd, EPOLL_CTL_DEL, c->fd, NULL);
+        }
+
+        long long t = now_ns();
+        if (t >= next_tick) {
+            next_tick = t + TICK_MS * 1000000LL;
+            for (int i = 0; i < sub_count; i++) {
+                sub_t* c = &subs[i];
+                if (c->cls == CLS_SLOW && !c->closed) {
+                    c->budget += slow_rate * TICK_MS / 1000.0;
+                    c->budget -= read_sub(c, (long)c->budget, 1);
+                } else if (c->cls == CLS_CHURN && done_ns == 0) {
+                    churn_tick(c, t);
+                }
+            }
+        }
+
+        if (done_ns == 0 && __atomic_load_n(&shm->done, __ATOMIC_ACQUIRE)) {
+            done_ns = t;
+            cpu1 = proc_cpu_s(server);
+            rss_kb = proc_status_kb(server, "VmRSS");
+            hwm_kb = proc_status_kb(server, "VmHWM");
+        }
+        // 송신이 끝난 뒤 빠른 클라이언트가 모두 받거나 2초가 지나면 종료
+        if (done_ns != 0) {
+            int pending = 0;
+            for (int i = 0; i < sub_count && !pending; i++) {
+                pending = subs[i].cls == CLS_FAST && !subs[i].closed && subs[i].received < total_alerts;
+            }
+            if (!pending || t - done_ns > 2000000000LL) break;
+        }
+    }
+    double wall_s = (done_ns - t_start) / 1e9;
+
+    // 느린/멈춘 클라이언트는 남은 데이터를 한 번에 읽어서 서버가 끊었는지(EOF) 확인
+    // (끊김은 버퍼에 쌓인 데이터를 다 읽어야 보이므로)
+    for (int i = 0; i < sub_count; i++) {
+        subs[i].delivered = subs[i].received;
+        if (subs[i].cls == CLS_SLOW || subs[i].cls == CLS_STALLED) read_sub(&subs[i], 1L << 30, 0);
+    }
+
+    kill(server, SIGKILL);
+    waitpid(server, NULL, 0);
+
+    // ----- 결과 -----
+    long long* fan = malloc(total_alerts * sizeof(long long));
+    memcpy(fan, shm->fanout_ns, total_alerts * sizeof(long long));
+    qsort(fan, total_alerts, sizeof(long long), cmp_ll);
+
+    printf("\n=== Alert Fan-out Load Test ===\n");
+    if (MAX_CLIENTS == SHIPPED_MAX_CLIENTS) {
+        printf("Server build: MAX_CLIENTS=%d (shipped configuration)\n", MAX_CLIENTS);
+    } else {
+        printf("Server build: MAX_CLIENTS=%d (load-test build, NOT shipped; shipped MAX_CLIENTS=%d -> make loadgen_shipped)\n",
+               MAX_CLIENTS, SHIPPED_MAX_CLIENTS);
+    }
+    printf("Alerts: %ld (%d bursts x %d, burst gap %d ms) in %.2f s\n", total_alerts, bursts, per_burst, burst_gap_ms, wall_s);
+    printf("send_alert() time : p50 %.3f  p99 %.3f  max %.3f ms\n",
+           pct_ms(fan, total_alerts, 50), pct_ms(fan, total_alerts, 99), pct_ms(fan, total_alerts, 100));
+    printf("%-8s %7s %8s %8s %10s %12s %8s %8s %8s %8s\n",
+           "class", "clients", "rejected", "evicted", "delivered", "expected", "p50", "p90", "p99", "max(ms)");
+    for (int cls = 0; cls < CLS_COUNT; cls++) {
+        if (cls == CLS_CHURN || counts[cls] == 0) continue;
+        long delivered = 0;
+        int evicted = 0;
+        for (int i = 0; i < sub_count; i++) {
+            if (subs[i].cls != cls) continue;
+            delivered += subs[i].delivered;
+            if (subs[i].closed) evicted++;
+        }
+        evicted -= rejected[cls];
+        int served = counts[cls] - rejected[cls];
+        qsort(lat[cls].v, lat[cls].n, sizeof(long long), cmp_ll);
+        printf("%-8s %7d %8d %8d %10ld %12ld %8.2f %8.2f %8.2f %8.2f\n",
+               cls_names[cls], counts[cls], rejected[cls], evicted, delivered, (long)served * total_alerts,
+               pct_ms(lat[cls].v, lat[cls].n, 50), pct_ms(lat[cls].v, lat[cls].n, 90),
+               pct_ms(lat[cls].v, lat[cls].n, 99), pct_ms(lat[cls].v, lat[cls].n, 100));
+    }
+    if (counts[CLS_CHURN] > 0) {
+        printf("churn    %7d connects %ld (%.0f/s), failed %ld\n",
+               counts[CLS_CHURN], churn_connects, churn_connects / wall_s, churn_refused);
+    }
+    printf("Server : CPU %.1f%% (%.2f s over %.2f s), RSS %ld kB (peak %ld kB)\n",
+           100.0 * (cpu1 - cpu0) / wall_s, cpu1 - cpu0, wall_s, rss_kb, hwm_kb);
+    printf("(stalled/slow clients are cut by the server once their send buffer fills; they must reconnect and RESEND)\n");
+    return 0;
+}
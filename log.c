@@ -0,0 +1,247 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "log.h"
+#include "clock.h"
+
+#define LOG_RING_SIZE   1024 // 쓰레드당 레코드 수 (2의 거듭제곱)
+#define LOG_MAX_RINGS   32
+#define LOG_DRAIN_MS    100
+
+typedef struct {
+    uint64_t head;     // 생산자(기록 쓰레드)만 씀
+    char pad1[56];     // head/tail 이 같은 캐시 라인에 있으면 서로 무효화됨
+    uint64_t tail;     // 소비자(드레인 쓰레드)만 씀
+    char pad2[56];
+    uint64_t dropped;  // 생산자만 증가
+    uint64_t dropped_reported; // 소비자만 씀
+    log_record_t buf[LOG_RING_SIZE];
+} log_ring_t;
+
+static const char* formats[LOG_FMT_COUNT] = {
+#define LOG_FMT(id, fmt) [id] = fmt,
+    LOG_FORMATS
+#undef LOG_FMT
+};
+
+static log_ring_t* rings[LOG_MAX_RINGS];
+static int ring_count = 0;
+static pthread_mutex_t ring_reg_mutex = PTHREAD_MUTEX_INITIALIZER; // 링 등록(쓰레드당 1회)에만 사용
+static __thread log_ring_t* my_ring = NULL;
+static __thread uint32_t my_ring_id = 0;
+static uint64_t unregistered_drops = 0; // 링 개수 초과로 버린 레코드
+
+static FILE* log_fp = NULL;
+static int log_echo = 0;
+static pthread_mutex_t drain_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static uint64_t mono_ns() {
+    return (uint64_t)clock_now_ns();
+}
+
+const char* log_format_string(int fmt_id) {
+    return (fmt_id >= 0 && fmt_id < LOG_FMT_COUNT) ? formats[fmt_id] : NULL;
+}
+
+// FNV-1a (포맷 표가 바뀌었는지 확인용)
+uint32_t log_format_hash() {
+    uint32_t h = 2166136261u;
+    for (int i = 0; i < LOG_FMT_COUNT; i++) {
+        for (const char* p = formats[i]; *p; p++) {
+            h ^= (unsigned char)*p;
+            h *= 16777619u;
+        }
+        h *= 16777619u; // 항목 구분
+    }
+    return h;
+}
+
+int log_init(const char* path, int echo_stdout) {
+    // 이전 실행(비정상 종료 포함)의 로그는 path.1 로 남겨 둠 (한 파일에 헤더 하나라서 이어 쓰지 않음)
+    char old_path[256];
+    snprintf(old_path, sizeof(old_path), "%s.1", path);
+    if (rename(path, old_path) != 0 && errno != ENOENT) {
+        perror("[Log] Unable to keep previous log");
+    }
+
+    log_fp = fopen(path, "wb");
+    if (log_fp == NULL) {
+        perror("[Log] Unable to open log file");
+        return -1;
+    }
+    log_echo = echo_stdout;
+
+    struct timespec real;
+    log_file_header_t hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, "SBLOG1", 6);
+    hdr.fmt_count = LOG_FMT_COUNT;
+    hdr.fmt_hash = log_format_hash();
+    hdr.mono_base_ns = mono_ns();
+    clock_gettime(CLOCK_REALTIME, &real);
+    hdr.real_base_ns = (uint64_t)real.tv_sec * 1000000000ULL + real.tv_nsec;
+    fwrite(&hdr, sizeof(hdr), 1, log_fp);
+    fflush(log_fp);
+    return 0;
+}
+
+// 쓰레드의 첫 기록 때 한 번만 호출 (이후로는 락 없음)
+static log_ring_t* register_ring() {
+    log_ring_t* ring = calloc(1, sizeof(log_ring_t));
+    if (ring == NULL) return NULL;
+
+    pthread_mutex_lock(&ring_reg_mutex);
+    if (ring_count >= LOG_MAX_RINGS) {
+        pthread_mutex_unlock(&ring_reg_mutex);
+        free(ring);
+        return NULL;
+    }
+    my_ring_id = ring_count;
+    // 드레인 쓰레드가 링 내용을 보기 전에 초기화가 끝나 있어야 함
+    __atomic_store_n(&rings[ring_count], ring, __ATOMIC_RELEASE);
+    __atomic_store_n(&ring_count, ring_count + 1, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&ring_reg_mutex);
+    return ring;
+}
+
+void log_write(int fmt_id, int nargs, uint64_t a0, uint64_t a1, uint64_t a2, uint64_t a3) {
+    log_ring_t* ring = my_ring;
+    if (ring == NULL) {
+        ring = my_ring = register_ring();
+        if (ring == NULL) {
+            __atomic_fetch_add(&unregistered_drops, 1, __ATOMIC_RELAXED);
+            return;
+        }
+    }
+
+    uint64_t head = ring->head;
+    uint64_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    if (head - tail >= LOG_RING_SIZE) {
+        // 가득 참 -> 기다리지 않고 버림
+        __atomic_store_n(&ring->dropped, ring->dropped + 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    log_record_t* rec = &ring->buf[head & (LOG_RING_SIZE - 1)];
+    rec->ts_ns = mono_ns();
+    rec->fmt_id = fmt_id;
+    rec->nargs = nargs;
+    rec->ring_id = my_ring_id;
+    rec->args[0] = a0;
+    rec->args[1] = a1;
+    rec->args[2] = a2;
+    rec->args[3] = a3;
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+// 한 레코드를 파일(및 콘솔)로 출력
+static void emit_record(const log_record_t* rec) {
+    fwrite(rec, sizeof(*rec), 1, log_fp);
+    if (log_echo) {
+        char text[256];
+        log_format_record(rec, text, sizeof(text));
+        printf("%s\n", text);
+    }
+}
+
+void log_drain() {
+    if (log_fp == NULL) return;
+
+    pthread_mutex_lock(&drain_mutex);
+    int count = __atomic_load_n(&ring_count, __ATOMIC_ACQUIRE);
+    for (int r = 0; r < count; r++) {
+        log_ring_t* ring = __atomic_load_n(&rings[r], __ATOMIC_ACQUIRE);
+        uint64_t tail = ring->tail;
+        uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+
+        for (; tail != head; tail++) {
+            emit_record(&ring->buf[tail & (LOG_RING_SIZE - 1)]);
+        }
+        __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+
+        // 버려진 레코드가 새로 생겼으면 드레인 쓰레드 이름으로 기록
+        uint64_t dropped = __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+        if (dropped != ring->dropped_reported) {
+            log_record_t rec = { mono_ns(), LOG_DROPPED, 3, r,
+                                 { r, dropped - ring->dropped_reported, dropped, 0 } };
+            emit_record(&rec);
+            ring->dropped_reported = dropped;
+        }
+    }
+    fflush(log_fp);
+    pthread_mutex_unlock(&drain_mutex);
+}
+
+// [쓰레드] 로그 드레인
+void* logDrainThreadFunc(void* arg) {
+    while (1) {
+        clock_sleep_ms(LOG_DRAIN_MS);
+        log_drain();
+    }
+    return NULL;
+}
+
+// 포맷 문자열의 변환 지정자마다 인자를 하나씩 꺼내 텍스트로 복원
+int log_format_record(const log_record_t* rec, char* out, size_t size) {
+    const char* fmt = log_format_string(rec->fmt_id);
+    size_t pos = 0;
+    int arg = 0;
+
+    if (fmt == NULL) {
+        return snprintf(out, size, "<unknown format %u>", rec->fmt_id);
+    }
+
+    out[0] = '\0';
+    for (const char* p = fmt; *p && pos < size - 1; ) {
+        if (*p != '%') {
+            out[pos++] = *p++;
+            out[pos] = '\0';
+            continue;
+        }
+        if (p[1] == '%') {
+            out[pos++] = '%';
+            out[pos] = '\0';
+            p += 2;
+            continue;
+        }
+
+        // 지정자 하나 분리: 플래그/폭/정밀도는 유지, 길이 수식어(l, h)는 버림
+        char spec[32];
+        int n = 0;
+        spec[n++] = *p++;
+        while (*p && strchr("-+ #0123456789.", *p) && n < 24) spec[n++] = *p++;
+        while (*p == 'l' || *p == 'h' || *p == 'z') p++;
+        char conv = *p ? *p++ : 'd';
+
+        uint64_t v = (arg < rec->nargs && arg < LOG_MAX_ARGS) ? rec->args[arg] : 0;
+        arg++;
+
+        int w;
+        if (strchr("fFeEgG", conv)) {
+            union { uint64_t u; double d; } x = { v };
+            spec[n++] = conv;
+            spec[n] = '\0';
+            w = snprintf(out + pos, size - pos, spec, x.d);
+        } else if (conv == 's') {
+            char str[9];
+            for (int i = 0; i < 8; i++) str[i] = (char)(v >> (8 * i));
+            str[8] = '\0';
+            spec[n++] = 's';
+            spec[n] = '\0';
+            w = snprintf(out + pos, size - pos, spec, str);
+        } else {
+            spec[n++] = 'l';
+            spec[n++] = 'l';
+            spec[n++] = conv;
+            spec[n] = '\0';
+            w = snprintf(out + pos, size - pos, spec, (long long)v);
+        }
+        if (w > 0) pos += ((size_t)w < size - pos) ? (size_t)w : size - pos - 1;
+    }
+    return (int)pos;
+}
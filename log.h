@@ -0,0 +1,63 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "log_formats.h"
+
+// 락 없는 바이너리 로그
+// - 쓰레드마다 자기 링 버퍼(생산자 1 : 소비자 1)를 가지므로 기록 시 락/시스템 콜이 없음
+// - 기록 = 타임스탬프 + 포맷 ID + 인자 (고정 크기 레코드)
+// - 링이 가득 차면 기다리지 않고 버린 뒤 개수만 셈
+// - 백그라운드 쓰레드(logDrainThreadFunc)가 파일로 옮기고, logdecode 가 텍스트로 복원
+
+#define LOG_MAX_ARGS 4
+
+typedef struct {
+    uint64_t ts_ns;    // CLOCK_MONOTONIC (ns)
+    uint16_t fmt_id;
+    uint16_t nargs;
+    uint32_t ring_id;  // 기록한 쓰레드의 링 번호
+    uint64_t args[LOG_MAX_ARGS];
+} log_record_t;
+
+typedef struct {
+    char magic[8];         // "SBLOG1"
+    uint32_t fmt_count;
+    uint32_t fmt_hash;     // 포맷 표 해시 (디코더와 표가 다르면 경고)
+    uint64_t mono_base_ns; // 시작 시각 (CLOCK_MONOTONIC)
+    uint64_t real_base_ns; // 같은 순간의 CLOCK_REALTIME (벽시계 시각으로 변환용)
+} log_file_header_t;
+
+int   log_init(const char* path, int echo_stdout); // echo_stdout: 드레인 쓰레드가 콘솔에도 출력
+void  log_write(int fmt_id, int nargs, uint64_t a0, uint64_t a1, uint64_t a2, uint64_t a3);
+void  log_drain();                               // 쌓인 레코드를 파일로 (드레인 쓰레드/종료 시)
+void* logDrainThreadFunc(void* arg);
+
+const char* log_format_string(int fmt_id);
+uint32_t    log_format_hash();
+int         log_format_record(const log_record_t* rec, char* out, size_t size); // 텍스트 복원
+
+// --- 인자 변환 (정수/실수/문자열을 64비트로) ---
+static inline uint64_t log_arg_int(long long v) { return (uint64_t)v; }
+static inline uint64_t log_arg_double(double v) {
+    union { double d; uint64_t u; } x = { v };
+    return x.u;
+}
+static inline uint64_t log_arg_str(const char* s) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8 && s[i]; i++) v |= (uint64_t)(unsigned char)s[i] << (8 * i);
+    return v;
+}
+#define LOG_ARG(x) _Generic((x), \
+    double: log_arg_double, float: log_arg_double, \
+    char*: log_arg_str, const char*: log_arg_str, \
+    default: log_arg_int)(x)
+
+#define LOG0(id)             log_write(id, 0, 0, 0, 0, 0)
+#define LOG1(id, a)          log_write(id, 1, LOG_ARG(a), 0, 0, 0)
+#define LOG2(id, a, b)       log_write(id, 2, LOG_ARG(a), LOG_ARG(b), 0, 0)
+#define LOG3(id, a, b, c)    log_write(id, 3, LOG_ARG(a), LOG_ARG(b), LOG_ARG(c), 0)
+#define LOG4(id, a, b, c, d) log_write(id, 4, LOG_ARG(a), LOG_ARG(b), LOG_ARG(c), LOG_ARG(d))
+
+#endif // LOG_H
@@ -0,0 +1,32 @@
+#ifndef LOG_FORMATS_H
+#define LOG_FORMATS_H
+
+// 바이너리 로그 포맷 표
+// LOG_FMT(ID, "printf 형식")  - 인자는 최대 4개
+//   정수(%d %ld %u %x ...) / 실수(%f %.1f ...) / 문자열(%s, 앞 8글자만 저장)
+// 로그 파일에는 ID 와 인자만 기록되고, 문자열은 logdecode 가 이 표로 복원합니다.
+// 순서를 바꾸면 예전 로그 파일을 읽을 수 없으므로 새 항목은 항상 맨 뒤에 추가하세요.
+
+#define LOG_FORMATS \
+    LOG_FMT(LOG_DROPPED,          "[Log] ring %d dropped %d records (total %d)") \
+    LOG_FMT(LOG_MODE_DANGER,      "!!! DANGER: Target Verified & Close (%.1f cm) !!!") \
+    LOG_FMT(LOG_MODE_WARN,        "--- Warning: Target Verified (Cam + PIR) ---") \
+    LOG_FMT(LOG_MODE_SAFE,        ">>> Condition not met (Cam:%d, PIR:%d). Safe Mode.") \
+    LOG_FMT(LOG_CAPTURE_REQUEST,  "[Camera] Capture request sent (incident %ld).") \
+    LOG_FMT(LOG_RATE_LEVEL,       ">>> [Governor] Rate level -> %s") \
+    LOG_FMT(LOG_BT_RECEIVED,      ">>> BT Received: %d bytes") \
+    LOG_FMT(LOG_BT_AUTH_USER,     ">>> BT: User authenticated (Normal).") \
+    LOG_FMT(LOG_BT_AUTH_ADMIN,    ">>> BT: User authenticated (Admin).") \
+    LOG_FMT(LOG_WIFI_CONNECTED,   ">>> Wi-Fi: New client connected. Index: %d") \
+    LOG_FMT(LOG_WIFI_REJECTED,    ">>> Wi-Fi: Max clients reached. Rejecting connection.") \
+    LOG_FMT(LOG_WIFI_SEND_FAILED, ">>> Wi-Fi: Send failed (client %d, errno %d). Closing.") \
+    LOG_FMT(LOG_CONFIG_APPLIED,   ">>> [Config] v%u (%s) in effect %.3f ms after publish, %.1f ms after change")
+
+enum {
+#define LOG_FMT(id, fmt) id,
+    LOG_FORMATS
+#undef LOG_FMT
+    LOG_FMT_COUNT
+};
+
+#endif // LOG_FORMATS_H
@@ -0,0 +1,54 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "config.h"
+#include "log.h"
+
+// =========================================================
+// 바이너리 로그 디코더
+// =========================================================
+// 사용법: ./logdecode [로그 파일 (기본: LOG_FILE_PATH)]
+// 출력: 벽시계 시각, 시작 후 경과 시간, 기록한 쓰레드(링) 번호, 복원된 메시지
+
+int main(int argc, char* argv[]) {
+    const char* path = (argc > 1) ? argv[1] : LOG_FILE_PATH;
+    FILE* fp = fopen(path, "rb");
+    if (fp == NULL) {
+        perror("[logdecode] open failed");
+        return 1;
+    }
+
+    log_file_header_t hdr;
+    if (fread(&hdr, sizeof(hdr), 1, fp) != 1 || memcmp(hdr.magic, "SBLOG1", 6) != 0) {
+        fprintf(stderr, "[logdecode] %s is not a sentry binary log\n", path);
+        fclose(fp);
+        return 1;
+    }
+    if (hdr.fmt_count != LOG_FMT_COUNT || hdr.fmt_hash != log_format_hash()) {
+        fprintf(stderr, "[logdecode] Warning: log was written by a different format table "
+                        "(%u formats, hash %08x; decoder has %d, %08x)\n",
+                hdr.fmt_count, hdr.fmt_hash, LOG_FMT_COUNT, log_format_hash());
+    }
+
+    log_record_t rec;
+    char text[256];
+    unsigned long count = 0;
+
+    while (fread(&rec, sizeof(rec), 1, fp) == 1) {
+        uint64_t real_ns = hdr.real_base_ns + (rec.ts_ns - hdr.mono_base_ns);
+        time_t sec = real_ns / 1000000000ULL;
+        struct tm tm;
+        char when[32];
+        localtime_r(&sec, &tm);
+        strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", &tm);
+
+        log_format_record(&rec, text, sizeof(text));
+        printf("%s.%06lu +%10.6f T%-2u %s\n", when, (unsigned long)(real_ns % 1000000000ULL) / 1000,
+               (rec.ts_ns - hdr.mono_base_ns) / 1e9, rec.ring_id, text);
+        count++;
+    }
+    fclose(fp);
+    fprintf(stderr, "[logdecode] %lu records\n", count);
+    return 0;
+}
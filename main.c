@@ -5,6 +5,7 @@
 #include <wiringPi.h>
 #include <wiringPiSPI.h>
 #include <signal.h> 
+#include <time.h>
 
 #include "config.h"
 #include "sensors.h"
@@ -12,36 +13,156 @@
 #include "motor.h"
 #include "bluetooth.h"
 #include "network.h"
+#include "boot.h"
+#include "watchdog.h"
+#include "governor.h"
+#include "runtime_config.h"
+#include "ranging.h"
+#include "state_shm.h"
+#include "clock.h"
+#include "log.h"
+#include "sentry_loop.h"
 
 // 전역 변수 실체화 (공유 자원)
 volatile int current_mode = MODE_SAFE;
 volatile int opencv_motion_detected = 0;
+volatile unsigned int camera_zone_mask = 0;
 pthread_mutex_t mode_mutex; 
 
-// Ctrl+C가 눌리면 이 함수가 소환됩니다.
-void emergency_shutdown(int sig) {
-    printf("\n>>> Force Shutdown Detected! Cleaning up...\n");
-    
+// Ctrl+C 는 표시만 하고, 정리는 메인 루프가 다음 바퀴에서 emergency_shutdown() 으로 함
+// (핸들러 안에서 로그 드레인의 락/stdio 를 쓰면 드레인 쓰레드가 락을 잡고 있을 때 멈춤)
+static volatile sig_atomic_t shutdown_requested = 0;
+
+static void on_sigint(int sig) {
+    (void)sig;
+    if (shutdown_requested) _exit(1); // 두 번째 Ctrl+C: 메인 루프가 멈춰 있어도 바로 종료
+    shutdown_requested = 1;
+    static const char msg[] = "\n>>> Force Shutdown Detected! Cleaning up...\n";
+    ssize_t n = write(STDOUT_FILENO, msg, sizeof(msg) - 1);
+    (void)n;
+}
+
+// 메인 쓰레드에서만 호출
+static void emergency_shutdown() {
     // 1. 장치들 끄기 (여기에 다 몰아넣으세요)
     cleanup_actuators();
     cleanup_motor();
     
-    // 2. 파이썬 카메라 끄기
-    system("pkill -f py_detector.py");
+    // 2. 파이썬 카메라 끄기 (감시 쓰레드가 띄운 자식 프로세스)
+    stop_python_detector();
+
+    // 남은 로그 기록
+    log_drain();
+
+    // 쓰레드별 멈춤 통계 / 감지 주기 수준별 CPU 출력
+    watchdog_report();
+    governor_report();
     
     // 3. 프로그램 진짜 종료
     exit(0);
 }
 
-int main() {
-    signal(SIGINT, emergency_shutdown);
+// =========================================================
+// 병렬 초기화 (서로 의존성이 없는 모듈은 동시에 초기화)
+// =========================================================
 
-    // 1. 라이브러리 초기화
-    if (wiringPiSetupGpio() == -1) return 1;
+typedef struct {
+    const char* name;
+    int (*fn)();
+    int result;
+} init_task_t;
+
+static int init_display_task() {
+    // 닷매트릭스는 SPI 가 열려 있어야 함 -> 같은 작업 안에서 순서대로
     if (wiringPiSPISetup(0, 1000000) == -1) {
         fprintf(stderr, ">>> ERROR: Unable to open SPI device /dev/spidev0.0.\n");
-        return 1;
+        return -1;
     }
+    init_actuators();
+    return 0;
+}
+static int init_sensors_task()   { init_sensors();   return 0; }
+static int init_motor_task()     { init_motor();     return 0; }
+static int init_bluetooth_task() { init_bluetooth(); return 0; }
+static int init_network_task()   { init_network();   return 0; }
+
+static void* initTaskThread(void* arg) {
+    init_task_t* task = (init_task_t*)arg;
+    long start_us = boot_elapsed_us();
+    task->result = task->fn();
+    boot_record(task->name, start_us, boot_elapsed_us());
+    return NULL;
+}
+
+// =========================================================
+// 공유 메모리 상태 미러 (대시보드 / 상태 LED / 헬스 익스포터용)
+// =========================================================
+
+// 메인 루프가 채운 판단 결과에 나머지 모듈 상태를 더해 기록 (메인 쓰레드에서만 호출)
+static void publish_state(sentry_state_t* st) {
+    static int last_mode = -1;
+    long long now = state_shm_now_ns();
+    struct timespec real;
+    clock_gettime(CLOCK_REALTIME, &real);
+
+    st->update_ns = now;
+    st->update_real_ms = (int64_t)real.tv_sec * 1000 + real.tv_nsec / 1000000;
+    st->config_version = rcfg_version();
+    st->rate_level = governor_level();
+    st->loops++;
+    if (st->mode != last_mode) {
+        if (last_mode != -1) st->mode_changes++;
+        st->mode_since_ns = now;
+        last_mode = st->mode;
+    }
+
+    // 초음파 측정 시각을 CLOCK_MONOTONIC 기준으로 변환
+    long ranging_now = ranging_now_us();
+    for (int z = 0; z < MAX_ZONES; z++) {
+        zone_reading_t r;
+        ranging_get_zone(z, &r);
+        st->zones[z].dist = r.dist;
+        st->zones[z].seq = (uint32_t)r.seq;
+        st->zones[z].measured_ns = r.seq ? now - (long long)(ranging_now - r.t_us) * 1000 : 0;
+    }
+    ranging_stats_t rs;
+    ranging_get_stats(&rs);
+    st->ranging_accepted = rs.accepted;
+    st->ranging_timeouts = rs.timeouts;
+    st->ranging_crosstalk = rs.crosstalk;
+
+    st->stalled_mask = 0;
+    for (int i = 0; i < HB_COUNT; i++) {
+        if (watchdog_is_stalled(i)) st->stalled_mask |= 1u << i;
+    }
+    int user_count, override;
+    get_auth_state(&user_count, &override);
+    st->auth_user_count = user_count;
+    st->admin_override = override;
+
+    state_shm_publish(st);
+}
+
+int main() {
+    boot_init();
+    signal(SIGINT, on_sigint);
+
+    // 제어 루프의 로그는 바이너리 링 버퍼로 (printf 대신), 드레인 쓰레드가 파일로 옮김
+    pthread_t th_log;
+    if (log_init(LOG_FILE_PATH, LOG_ECHO_STDOUT) == 0) {
+        pthread_create(&th_log, NULL, logDrainThreadFunc, NULL);
+        pthread_detach(th_log);
+    }
+
+    // 0. 카메라 파이프라인이 가장 오래 걸리므로 제일 먼저 띄움
+    //    (FIFO 를 먼저 만들어야 Python 쪽 open 이 실패하지 않음)
+    if (init_opencv_fifo() == -1) return 1;
+    start_python_detector();
+
+    // 1. 라이브러리 초기화 (GPIO 는 다른 모듈의 전제 조건이라 먼저)
+    long t = boot_elapsed_us();
+    if (wiringPiSetupGpio() == -1) return 1;
+    boot_record("gpio", t, boot_elapsed_us());
 
     // 1-1. 뮤텍스 초기화
     if (pthread_mutex_init(&mode_mutex, NULL) != 0) {
@@ -49,113 +170,100 @@ int main() {
         return 1;
     }
 
-    // 2. 모듈별 초기화
-    init_sensors();
-    init_actuators();
-    init_motor();     
-    init_bluetooth(); 
-    init_network();   
+    // 1-2. 실행 중 설정 읽기 -> 감지 주기 조절 (PIR 인터럽트가 init_sensors 에서 등록되므로 먼저)
+    rcfg_init(RUNTIME_CONFIG_PATH);
+    init_governor();
+    rcfg_on_change(governor_config_changed);
 
-    // === Python Detector 자동 실행 (IPC 시작) ===
-    start_python_detector();
+    // 1-3. 상태 미러 (실패해도 계속 동작)
+    sentry_state_t st = {0};
+    struct timespec started;
+    clock_gettime(CLOCK_REALTIME, &started);
+    st.started_real_ms = (int64_t)started.tv_sec * 1000 + started.tv_nsec / 1000000;
+    st.pid = getpid();
+    state_shm_init();
 
-    // 3. 쓰레드 시작
+    // 1-4. 하트비트 감시 기준 시각 (이후 생성되는 쓰레드들이 grace 시간 안에 뛰어야 함)
+    watchdog_init();
+
+    // 1-5. 파이프 리더는 바로 시작 (Python 이 준비되는 즉시 결과를 받도록)
     pthread_t th_disp, th_buzz, th_pipe_reader;
-    pthread_t th_bt, th_wifi; 
+    pthread_t th_bt, th_wifi, th_ranging; 
+    pthread_create(&th_pipe_reader, NULL, opencvPipeReadThread, NULL);
+
+    // 2. 모듈별 초기화 (병렬)
+    init_task_t tasks[] = {
+        { "spi+actuators", init_display_task,   0 },
+        { "sensors",       init_sensors_task,   0 },
+        { "motor",         init_motor_task,     0 },
+        { "bluetooth",     init_bluetooth_task, 0 },
+        { "network",       init_network_task,   0 },
+    };
+    const int task_count = sizeof(tasks) / sizeof(tasks[0]);
+    pthread_t th_init[sizeof(tasks) / sizeof(tasks[0])];
+
+    t = boot_elapsed_us();
+    for (int i = 0; i < task_count; i++) {
+        pthread_create(&th_init[i], NULL, initTaskThread, &tasks[i]);
+    }
+    for (int i = 0; i < task_count; i++) {
+        pthread_join(th_init[i], NULL);
+    }
+    boot_record("modules(total)", t, boot_elapsed_us());
 
+    for (int i = 0; i < task_count; i++) {
+        if (tasks[i].result != 0) {
+            fprintf(stderr, ">>> ERROR: %s initialization failed.\n", tasks[i].name);
+            stop_python_detector();
+            return 1;
+        }
+    }
+
+    // 3. 쓰레드 시작
+    t = boot_elapsed_us();
+    pthread_t th_watchdog;
+    pthread_create(&th_watchdog, NULL, watchdogThreadFunc, NULL);
     pthread_create(&th_disp, NULL, displayThreadFunc, NULL);
     pthread_create(&th_buzz, NULL, buzzerThreadFunc, NULL);
-    pthread_create(&th_pipe_reader, NULL, opencvPipeReadThread, NULL);
     pthread_create(&th_bt, NULL, bluetoothThreadFunc, NULL);
     pthread_create(&th_wifi, NULL, wifiServerThreadFunc, NULL);
+    pthread_create(&th_ranging, NULL, rangingThreadFunc, NULL);
+    pthread_t th_config;
+    pthread_create(&th_config, NULL, configWatchThreadFunc, NULL);
+    pthread_detach(th_config);
+    boot_record("threads", t, boot_elapsed_us());
 
     printf(">>> Sentry System Started (Full Integration) <<<\n");
     printf("State: SAFE (Monitoring Camera Motion OR PIR...)\n");
 
-    int camera_triggered = 0;
-    int capture_done = 0;
-    int local_mode;
-    int opencv_detected;
-    int last_alert_mode = MODE_SAFE;
+    sentry_loop_t loop;
+    sentry_loop_init(&loop);
 
-    // 4. 메인 루프 (수정된 시나리오: Cam+PIR 필수 -> 이후 거리 측정)
+    // 4. 메인 루프 (판단 규칙은 sentry_loop.c - 시나리오 시뮬레이션과 같은 코드)
     while (1) {
+        // [부팅] 모든 모듈 + 첫 감지 결과까지 준비되면 ARMED 보고 (1회)
+        if (boot_is_detector_ready()) {
+            boot_report_armed();
+        }
+        if (shutdown_requested) {
+            emergency_shutdown();
+        }
+        watchdog_beat(HB_MAIN);
+
         // [모터 제어]
         int locked = is_motor_locked();
         set_motor_state(locked);
+        st.motor_locked = locked;
 
-        // [LOCK] OpenCV 감지 결과 읽기
-        pthread_mutex_lock(&mode_mutex);
-        opencv_detected = opencv_motion_detected;
-        pthread_mutex_unlock(&mode_mutex);
-
-        // --- 1. PIR 센서 값 읽기 ---
-        int pir_detected = check_pir();
-
-        // --- 2. 시나리오 판단 시작 ---
-        
-        // [조건 1] 카메라와 PIR이 '둘 다' 감지되었는가? (AND 조건)
-        if (opencv_detected == 1 && pir_detected == 1) {
-            
-            // 1차 조건 만족! 이제야 비로소 거리를 측정합니다.
-            static double safe_dist = 0; 
-            double raw_dist = get_distance();
-            if (raw_dist != -1) {
-                safe_dist = raw_dist;
-            }
-            double dist = safe_dist;
-
-            // [조건 2] 거리가 위험 수준인가?
-            if (dist > 0 && dist < DIST_DANGER) {
-                // -> MODE_DANGER (침입자가 확실하고, 거리도 가까움)
-                pthread_mutex_lock(&mode_mutex);
-                local_mode = current_mode;
-
-                if (local_mode != MODE_DANGER) {
-                    printf("!!! DANGER: Target Verified & Close (%.1f cm) !!!\n", dist);
-                    if (last_alert_mode != MODE_DANGER) {
-                        send_alert(MODE_DANGER);
-                        last_alert_mode = MODE_DANGER;
-                    }
-                }
-                current_mode = MODE_DANGER;
-                pthread_mutex_unlock(&mode_mutex);
-
-                // 사진 캡처
-                if (capture_done == 0) {
-                    capture_image();
-                    capture_done = 1;
-                }
-            }
-            else {
-                // -> MODE_WARN (침입자는 맞는데, 아직 거리는 멂)
-                pthread_mutex_lock(&mode_mutex);
-                local_mode = current_mode;
-
-                if (local_mode != MODE_WARN) {
-                    printf("--- Warning: Target Verified (Cam + PIR) ---\n");
-                    if (last_alert_mode != MODE_WARN) {
-                        send_alert(MODE_WARN);
-                        last_alert_mode = MODE_WARN;
-                    }
-                }
-                current_mode = MODE_WARN;
-                capture_done = 0; // WARN 상태에서는 캡처 플래그 초기화
-                pthread_mutex_unlock(&mode_mutex);
-            }
-        }
-        // [조건 불만족] 카메라나 PIR 중 하나라도 감지 안 되면 -> SAFE
-        else {
-            pthread_mutex_lock(&mode_mutex);
-            if (current_mode != MODE_SAFE) {
-                printf(">>> Condition not met (Cam:%d, PIR:%d). Safe Mode.\n", opencv_detected, pir_detected);
-                current_mode = MODE_SAFE;
-                last_alert_mode = MODE_SAFE;
-            }
-            pthread_mutex_unlock(&mode_mutex);
-        }
+        // 센서 읽기 -> 모드 판단 -> 경보 / 사진 요청
+        int local_mode = sentry_loop_step(&loop, &st);
+
+        // [상태 미러] 이번 바퀴의 결과 기록 (읽는 쪽이 몇이든 기다리지 않음)
+        publish_state(&st);
 
-        delay(50); // 루프 주기
+        // 위협 수준에 따라 루프 주기 조절 (PIR 에지가 오면 즉시 깨어남)
+        governor_update(local_mode, st.pir_detected);
+        governor_sleep_ms(governor_period_ms(GOV_MAIN_LOOP)); // 루프 주기
     }
 
     // 종료 처리
@@ -168,6 +276,8 @@ int main() {
     pthread_join(th_buzz, NULL);
     pthread_join(th_bt, NULL);
     pthread_join(th_wifi, NULL);
+    pthread_join(th_ranging, NULL);
+    pthread_join(th_watchdog, NULL);
 
     pthread_mutex_destroy(&mode_mutex);
 
@@ -0,0 +1,172 @@
+import cv2
+import numpy as np
+
+from blob_tracker import BlobTracker, MIN_BLOB_AREA
+
+# 움직임 감지기 (관심 영역 ROI + 다중 해상도)
+# - 구역(zone)마다 관심 영역 다각형을 받아 시작할 때 한 번만 마스크로 변환
+#   (구역 번호 맵, ROI 비트마스크, 타일 격자 - 모두 ROI 를 감싸는 사각형 기준으로 잘라 둠)
+# - 매 프레임 1/2^levels 로 줄인 영상에서 먼저 차이를 보고, 바뀐 타일 중 ROI 에 걸친 타일만
+#   원래 해상도로 차이 -> 임계값 -> 팽창 (바뀐 타일은 줄 단위 연속 구간(run)으로 묶어 사각형 몇 개로 처리)
+# - 하늘/벽/길거리처럼 ROI 밖은 원래 해상도로 보지 않으므로 오탐도 없고 비용도 들지 않음
+# - levels = 0, roi 없음 이면 예전처럼 화면 전체를 원래 해상도로 처리 (벤치마크 비교용)
+#
+# 카메라 설정 (camera_pipeline.py 의 카메라 dict 에 추가)
+#   roi            : [(구역 번호, [(x, y), ...]), ...] - 좌표는 화면 비율 (0.0 ~ 1.0)
+#                    없으면 zones 의 세로 띠를 그대로 ROI 로 사용 (화면 전체)
+#   pyramid_levels : 축소 단계 수 (기본 2: 640x480 -> 160x120, 0: 축소 없이 바로 원래 해상도)
+
+DEFAULT_THRESHOLD = 25
+DEFAULT_PYRAMID_LEVELS = 2
+TILE = 32                       # 원래 해상도 타일 크기 (px), 축소 단계는 TILE 을 나눌 수 있어야 함
+COARSE_THRESHOLD_RATIO = 0.5    # 축소하면 물체 가장자리 차이가 평균되어 약해지므로 임계값을 낮춤
+NO_ZONE = 255
+
+
+class CompiledRoi:
+    """ROI 다각형을 미리 변환한 결과 (모두 rect 기준 좌표)"""
+    __slots__ = ("rect", "labels", "mask", "whole", "tiles")
+
+
+def compile_roi(roi, zones, size):
+    """roi (또는 zones 세로 띠) 를 구역 번호 맵 / 비트마스크 / 타일 격자로 변환"""
+    w, h = size
+    labels = np.full((h, w), NO_ZONE, np.uint8)
+    if roi:
+        for zone, points in roi:
+            poly = np.array([(round(x * w), round(y * h)) for x, y in points], np.int32)
+            cv2.fillPoly(labels, [poly], int(zone))
+    else:
+        # 예전 방식: 중심 x 가 x0 <= x < x1 인 구역
+        for zone, x0, x1 in zones:
+            labels[:, round(x0 * w):round(x1 * w)] = zone
+
+    # ROI 를 감싸는 사각형 (타일 경계에 맞춤) - 이 밖은 매 프레임 아예 보지 않음
+    ys, xs = np.nonzero(labels != NO_ZONE)
+    if len(xs) == 0:
+        raise ValueError("ROI is empty")
+    x0, y0 = xs.min() // TILE * TILE, ys.min() // TILE * TILE
+    x1, y1 = min(w, -(-(xs.max() + 1) // TILE) * TILE), min(h, -(-(ys.max() + 1) // TILE) * TILE)
+
+    r = CompiledRoi()
+    r.rect = (int(x0), int(y0), int(x1), int(y1))
+    r.labels = np.ascontiguousarray(labels[y0:y1, x0:x1])
+    r.mask = np.where(r.labels != NO_ZONE, 255, 0).astype(np.uint8)
+    r.whole = bool(r.mask.all())
+    # ROI 에 한 픽셀이라도 걸친 타일
+    th, tw = -(-(y1 - y0) // TILE), -(-(x1 - x0) // TILE)
+    padded = np.zeros((th * TILE, tw * TILE), np.uint8)
+    padded[:y1 - y0, :x1 - x0] = r.mask
+    r.tiles = padded.reshape(th, TILE, tw, TILE).max(axis=(1, 3)) > 0
+    return r
+
+
+def tile_runs(active):
+    """활성 타일 격자 -> 사각형 목록 (타일 단위 (tx0, ty0, tx1, ty1))
+    줄마다 연속 구간으로 묶고, 바로 윗줄과 구간이 같으면 세로로 이어 붙임"""
+    rects, open_runs = [], {}
+    for ty, row in enumerate(active):
+        runs = {}
+        tx, n = 0, len(row)
+        while tx < n:
+            if not row[tx]:
+                tx += 1
+                continue
+            start = tx
+            while tx < n and row[tx]:
+                tx += 1
+            run = (start, tx)
+            runs[run] = open_runs.pop(run, ty)
+        for (tx0, tx1), ty0 in open_runs.items():
+            rects.append((tx0, ty0, tx1, ty))
+        open_runs = runs
+    for (tx0, tx1), ty0 in open_runs.items():
+        rects.append((tx0, ty0, tx1, len(active)))
+    return rects
+
+
+class MotionDetector:
+    def __init__(self, cam, size):
+        self.threshold = cam.get("threshold", DEFAULT_THRESHOLD)
+        self.levels = cam.get("pyramid_levels", DEFAULT_PYRAMID_LEVELS)
+        if TILE % (1 << self.levels):
+            raise ValueError(f"pyramid_levels {self.levels} does not divide tile size {TILE}")
+        self.roi = compile_roi(cam.get("roi"), cam.get("zones", [(0, 0.0, 1.0)]), size)
+        self.tracker = BlobTracker(cam.get("min_blob_area", MIN_BLOB_AREA))
+
+        x0, y0, x1, y1 = self.roi.rect
+        self.thresh = np.zeros((y1 - y0, x1 - x0), np.uint8)
+        self.dirty = []          # 지난 프레임에 thresh 에 쓴 사각형 (다음 프레임에 그 부분만 지움)
+        self.prev = None
+        self.prev_coarse = None
+        # 벤치마크용 누적 처리량
+        self.frames = 0
+        self.pixels = 0          # 원래 해상도로 차이/임계값/팽창을 한 픽셀 수
+        self.coarse_pixels = 0   # 축소 영상에서 차이를 본 픽셀 수
+
+    def _coarse(self, gray):
+        h, w = gray.shape
+        return cv2.resize(gray, (w >> self.levels, h >> self.levels), interpolation=cv2.INTER_AREA)
+
+    def _active_rects(self, coarse):
+        """축소 영상에서 바뀐 타일 (ROI 에 걸친 것만) -> 원래 해상도 사각형 목록"""
+        h, w = self.thresh.shape
+        if self.levels == 0:
+            return [(0, 0, w, h)]
+        diff = cv2.absdiff(self.prev_coarse, coarse)
+        _, changed = cv2.threshold(diff, max(1, int(self.threshold * COARSE_THRESHOLD_RATIO)), 255, cv2.THRESH_BINARY)
+        changed = cv2.dilate(changed, None)  # 가장자리 타일과 원래 해상도 팽창분까지 포함
+        self.coarse_pixels += diff.size
+
+        ct = TILE >> self.levels
+        th, tw = self.roi.tiles.shape
+        padded = np.zeros((th * ct, tw * ct), np.uint8)
+        padded[:changed.shape[0], :changed.shape[1]] = changed
+        active = (padded.reshape(th, ct, tw, ct).max(axis=(1, 3)) > 0) & self.roi.tiles
+        if not active.any():
+            return []
+        return [(tx0 * TILE, ty0 * TILE, min(w, tx1 * TILE), min(h, ty1 * TILE))
+                for tx0, ty0, tx1, ty1 in tile_runs(active)]
+
+    def update(self, frame):
+        """원래 해상도 회색조 프레임 1장 처리 후 구역 비트마스크 반환 (bit n = 구역 n 에 추적 대상 존재)"""
+        x0, y0, x1, y1 = self.roi.rect
+        gray = frame[y0:y1, x0:x1]
+        coarse = self._coarse(gray) if self.levels else None
+        if self.prev is None:
+            self.prev, self.prev_coarse = gray, coarse
+
+        for rx0, ry0, rx1, ry1 in self.dirty:
+            self.thresh[ry0:ry1, rx0:rx1] = 0
+        self.dirty = self._active_rects(coarse)
+        for rx0, ry0, rx1, ry1 in self.dirty:
+            diff = cv2.absdiff(self.prev[ry0:ry1, rx0:rx1], gray[ry0:ry1, rx0:rx1])
+            _, t = cv2.threshold(diff, self.threshold, 255, cv2.THRESH_BINARY)
+            t = cv2.dilate(t, None, iterations=2)
+            if not self.roi.whole:
+                t = cv2.bitwise_and(t, self.roi.mask[ry0:ry1, rx0:rx1])
+            self.thresh[ry0:ry1, rx0:rx1] = t
+            self.pixels += diff.size
+
+        # 움직임이 없으면 연결 요소 탐색은 건너뜀 (멈춘 대상 확인 / 배경 갱신은 그대로)
+        self.tracker.update(gray, self.thresh if self.dirty else None)
+        self.prev, self.prev_coarse = gray, coarse
+        self.frames += 1
+        return self.zone_mask()
+
+    def zone_mask(self, moving_only=False):
+        """확인된 대상이 있는 구역 비트마스크 (moving_only: 이번 프레임에 움직인 대상만)"""
+        labels = self.roi.labels
+        h, w = labels.shape
+        mask = 0
+        tracks = self.tracker.moving_tracks() if moving_only else self.tracker.confirmed_tracks()
+        for t in tracks:
+            zone = labels[min(h - 1, int(t.cy)), min(w - 1, int(t.cx))]
+            if zone == NO_ZONE:
+                # 중심이 ROI 밖 (ㄱ자 모양 등) -> 박스 안에서 가장 많이 겹치는 구역
+                counts = np.bincount(labels[t.y:t.y + t.h, t.x:t.x + t.w].ravel(), minlength=NO_ZONE + 1)[:NO_ZONE]
+                if not counts.any():
+                    continue
+                zone = counts.argmax()
+            mask |= 1 << int(zone)
+        return mask
@@ -7,10 +7,220 @@
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <netinet/in.h>
+#include <poll.h>
+#include <time.h>
+#include <errno.h>
+#include <endian.h>
+#include "watchdog.h"
+#include "log.h"
+#include "alert_proto.h"
+#include "runtime_config.h"
+#include "clock.h"
 
 static int server_fd;
 static struct sockaddr_in address;
 static int client_sockets[MAX_CLIENTS]; // Ŭ���̾�Ʈ ���� �迭
+static pthread_mutex_t clients_mutex = PTHREAD_MUTEX_INITIALIZER; // 메인 루프/감시 쓰레드/서버 쓰레드 동시 접근 보호
+static char client_rx[MAX_CLIENTS][64]; // 클라이언트 명령 수신 버퍼 (한 줄 단위)
+static int client_rx_len[MAX_CLIENTS];
+
+// --- 경보 기록 (번호 부여) 및 UDP 멀티캐스트 ---
+#if ALERT_REDUNDANCY + 1 > ALERT_MAX_ENTRIES
+#error "ALERT_REDUNDANCY too large for one multicast packet"
+#endif
+
+static alert_pkt_entry_t alert_history[ALERT_HISTORY]; // 호스트 바이트 순서, seq % ALERT_HISTORY 위치
+static uint32_t alert_seq = 0;        // 마지막으로 부여한 번호
+static uint32_t alert_boot_id = 0;
+static long long last_mcast_ms = 0;
+static int mcast_fd = -1;
+static struct sockaddr_in mcast_addr;
+static pthread_mutex_t alert_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void init_multicast() {
+#if ALERT_MCAST_ENABLE
+    unsigned char ttl = ALERT_MCAST_TTL;
+    unsigned char loop = 1; // 같은 장치의 수신기(시험용)도 받도록
+    struct in_addr iface;
+
+    mcast_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (mcast_fd < 0) {
+        perror("[Alert] Multicast socket failed");
+        return;
+    }
+    inet_pton(AF_INET, ALERT_MCAST_IFACE, &iface);
+    setsockopt(mcast_fd, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+    setsockopt(mcast_fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+    if (setsockopt(mcast_fd, IPPROTO_IP, IP_MULTICAST_IF, &iface, sizeof(iface)) < 0) {
+        perror("[Alert] IP_MULTICAST_IF");
+    }
+
+    memset(&mcast_addr, 0, sizeof(mcast_addr));
+    mcast_addr.sin_family = AF_INET;
+    mcast_addr.sin_port = htons(ALERT_MCAST_PORT);
+    inet_pton(AF_INET, ALERT_MCAST_GROUP, &mcast_addr.sin_addr);
+
+    printf(">>> [Alert] Multicast alerts on %s:%d (unit %d)\n", ALERT_MCAST_GROUP, ALERT_MCAST_PORT, ALERT_UNIT_ID);
+#endif
+}
+
+// 최신 경보 + 직전 경보 ALERT_REDUNDANCY 개를 한 패킷으로 전송 (alert_mutex 보유 상태에서 호출)
+static void send_multicast_locked(uint8_t flags) {
+    unsigned char pkt[ALERT_PKT_MAX_SIZE];
+    alert_pkt_header_t* hdr = (alert_pkt_header_t*)pkt;
+    alert_pkt_entry_t* entries = (alert_pkt_entry_t*)(pkt + sizeof(*hdr));
+    int count = 0;
+
+    if (mcast_fd < 0) return;
+
+    for (uint32_t seq = alert_seq; seq > 0 && count <= ALERT_REDUNDANCY; seq--, count++) {
+        const alert_pkt_entry_t* e = &alert_history[seq % ALERT_HISTORY];
+        entries[count].seq = htonl(e->seq);
+        entries[count].real_ms = htobe64(e->real_ms);
+        entries[count].mode = e->mode;
+        memcpy(entries[count].text, e->text, ALERT_TEXT_LEN);
+    }
+    hdr->magic = htonl(ALERT_MAGIC);
+    hdr->unit_id = htons(ALERT_UNIT_ID);
+    hdr->count = count;
+    hdr->flags = flags;
+    hdr->boot_id = htonl(alert_boot_id);
+    hdr->latest_seq = htonl(alert_seq);
+
+    // 수신자 수와 무관하게 전송 1회. 버퍼가 차 있으면 기다리지 않음 (다음 패킷/하트비트가 다시 실어 감)
+    sendto(mcast_fd, pkt, sizeof(*hdr) + count * sizeof(alert_pkt_entry_t), MSG_DONTWAIT,
+           (struct sockaddr*)&mcast_addr, sizeof(mcast_addr));
+    last_mcast_ms = clock_now_ms();
+}
+
+// 경보에 번호를 붙여 기록하고 멀티캐스트로 전송
+static void record_alert(int mode, const char* text) {
+    struct timespec real;
+    clock_gettime(CLOCK_REALTIME, &real);
+
+    pthread_mutex_lock(&alert_mutex);
+    alert_seq++;
+    alert_pkt_entry_t* e = &alert_history[alert_seq % ALERT_HISTORY];
+    e->seq = alert_seq;
+    e->real_ms = (uint64_t)real.tv_sec * 1000 + real.tv_nsec / 1000000;
+    e->mode = mode;
+    strncpy(e->text, text, ALERT_TEXT_LEN - 1);
+    e->text[ALERT_TEXT_LEN - 1] = '\0';
+    send_multicast_locked(0);
+    pthread_mutex_unlock(&alert_mutex);
+}
+
+// 경보가 뜸할 때도 최신 번호를 알려서 마지막 경보 손실을 수신 측이 알아챌 수 있게 함
+static void multicast_heartbeat() {
+    pthread_mutex_lock(&alert_mutex);
+    if (clock_now_ms() - last_mcast_ms >= ALERT_HEARTBEAT_MS) {
+        send_multicast_locked(ALERT_FLAG_HEARTBEAT);
+    }
+    pthread_mutex_unlock(&alert_mutex);
+}
+
+// TCP 따라잡기 요청 처리: from_seq 이후 남아 있는 경보를 한 줄씩 전송 (clients_mutex 보유 상태에서 호출)
+static void handle_resend(int fd, uint32_t from_seq) {
+    char line[ALERT_TEXT_LEN + 64];
+
+    pthread_mutex_lock(&alert_mutex);
+    uint32_t oldest = (alert_seq >= ALERT_HISTORY) ? alert_seq - ALERT_HISTORY + 1 : 1;
+    if (from_seq < oldest) from_seq = oldest;
+    for (uint32_t seq = from_seq; seq <= alert_seq; seq++) {
+        const alert_pkt_entry_t* e = &alert_history[seq % ALERT_HISTORY];
+        int n = snprintf(line, sizeof(line), "ALERT %u %llu %u %s\n",
+                         e->seq, (unsigned long long)e->real_ms, e->mode, e->text);
+        send(fd, line, n, MSG_DONTWAIT | MSG_NOSIGNAL);
+    }
+    int n = snprintf(line, sizeof(line), "END %u\n", alert_seq);
+    send(fd, line, n, MSG_DONTWAIT | MSG_NOSIGNAL);
+    pthread_mutex_unlock(&alert_mutex);
+}
+
+// 클라이언트 슬롯 해제 (clients_mutex 보유 상태에서 호출)
+static void drop_client(int i) {
+    close(client_sockets[i]);
+    client_sockets[i] = 0;
+    client_rx_len[i] = 0;
+}
+
+// 관리자 설정 명령: "ADMIN <비밀번호> RELOAD" / "ADMIN <비밀번호> SET key value"
+// SET 은 설정 파일 기록 + fsync 를 하므로 clients_mutex 밖에서 실행 (경보 전송이 SD 카드를 기다리지 않도록)
+// -> handle_client_input 은 명령과 fd 사본(dup)만 모아 두고, 쓰레드가 락을 놓은 뒤 run_admin_commands 로 처리
+#define ADMIN_QUEUE 8
+
+typedef struct {
+    int fd;                        // dup 한 fd (처리 중에 슬롯이 끊기고 재사용돼도 원래 연결로 응답)
+    char line[sizeof(client_rx[0])];
+} admin_cmd_t;
+
+static admin_cmd_t admin_queue[ADMIN_QUEUE]; // 네트워크 쓰레드 전용
+static int admin_count = 0;
+
+static void handle_admin(int fd, char* line) {
+    char reply[200];
+    char* pw = line + strlen(ALERT_ADMIN_CMD) + strspn(line + strlen(ALERT_ADMIN_CMD), " ");
+    int pw_len = strcspn(pw, " ");
+    const runtime_config_t* cfg = rcfg_acquire();
+    int pw_ok = pw_len == (int)strlen(cfg->admin_password) && strncmp(pw, cfg->admin_password, pw_len) == 0;
+    rcfg_release(cfg); // 명령이 새 스냅샷을 만들기 전에 놓음
+
+    if (!pw_ok) {
+        snprintf(reply, sizeof(reply), "ERR bad password\n");
+    } else if (rcfg_admin_command(pw + pw_len + strspn(pw + pw_len, " "), "tcp", reply, sizeof(reply) - 1)) {
+        strcat(reply, "\n");
+    } else {
+        snprintf(reply, sizeof(reply), "ERR usage: ADMIN <password> RELOAD | SET key value\n");
+    }
+    send(fd, reply, strlen(reply), MSG_DONTWAIT | MSG_NOSIGNAL);
+}
+
+// 클라이언트가 보낸 데이터 처리 (clients_mutex 보유 상태에서 호출)
+static void handle_client_input(int i) {
+    char* buf = client_rx[i];
+    int n = recv(client_sockets[i], buf + client_rx_len[i], sizeof(client_rx[i]) - 1 - client_rx_len[i], MSG_DONTWAIT);
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+        drop_client(i); // 연결 종료
+        return;
+    }
+    if (n < 0) return;
+    client_rx_len[i] += n;
+    buf[client_rx_len[i]] = '\0';
+
+    char* nl;
+    while ((nl = strchr(buf, '\n')) != NULL) {
+        unsigned int from_seq;
+        *nl = '\0';
+        if (nl > buf && nl[-1] == '\r') nl[-1] = '\0';
+        if (sscanf(buf, ALERT_RESEND_CMD " %u", &from_seq) == 1) {
+            handle_resend(client_sockets[i], from_seq);
+        } else if (strncmp(buf, ALERT_ADMIN_CMD " ", strlen(ALERT_ADMIN_CMD) + 1) == 0) {
+            int fd = admin_count < ADMIN_QUEUE ? dup(client_sockets[i]) : -1;
+            if (fd >= 0) {
+                admin_queue[admin_count].fd = fd;
+                snprintf(admin_queue[admin_count].line, sizeof(admin_queue[0].line), "%s", buf);
+                admin_count++;
+            } else {
+                static const char busy[] = "ERR busy\n";
+                send(client_sockets[i], busy, sizeof(busy) - 1, MSG_DONTWAIT | MSG_NOSIGNAL);
+            }
+        }
+        client_rx_len[i] -= (nl + 1 - buf);
+        memmove(buf, nl + 1, client_rx_len[i] + 1);
+    }
+    if (client_rx_len[i] >= (int)sizeof(client_rx[i]) - 1) {
+        client_rx_len[i] = 0; // 줄바꿈 없는 긴 입력은 버림
+    }
+}
+
+// 모아 둔 관리자 명령 처리 (clients_mutex 를 놓은 상태에서 호출)
+static void run_admin_commands() {
+    for (int k = 0; k < admin_count; k++) {
+        handle_admin(admin_queue[k].fd, admin_queue[k].line);
+        close(admin_queue[k].fd);
+    }
+    admin_count = 0;
+}
 
 void init_network() {
     // 1. ���� ���� ��ũ���� ����
@@ -38,7 +248,7 @@ void init_network() {
     }
 
     // 5. ���� ��û ���
-    if (listen(server_fd, 3) < 0) {
+    if (listen(server_fd, WIFI_LISTEN_BACKLOG) < 0) {
         perror("Listen failed");
         exit(EXIT_FAILURE);
     }
@@ -46,8 +256,12 @@ void init_network() {
     // Ŭ���̾�Ʈ ���� �迭 �ʱ�ȭ
     for (int i = 0; i < MAX_CLIENTS; i++) {
         client_sockets[i] = 0;
+        client_rx_len[i] = 0;
     }
 
+    alert_boot_id = (uint32_t)time(NULL);
+    init_multicast();
+
     printf(">>> Wi-Fi Server Initialized on port %d (Alerts Ready)\n", WIFI_SERVER_PORT);
 }
 
@@ -55,28 +269,71 @@ void init_network() {
 void* wifiServerThreadFunc(void* arg) {
     int addrlen = sizeof(address);
     int new_socket;
+    struct pollfd pfds[1 + MAX_CLIENTS];
+    int slot_of[1 + MAX_CLIENTS];
 
+    printf(">>> Wi-Fi: Waiting for a client connection...\n");
     while (1) {
-        printf(">>> Wi-Fi: Waiting for a client connection...\n");
+        // accept() 에서 무한정 막히지 않도록 poll 타임아웃마다 하트비트
+        watchdog_beat(HB_WIFI);
+        multicast_heartbeat();
+
+        // 새 연결 + 연결된 클라이언트의 명령(RESEND)을 함께 대기
+        int nfds = 0;
+        pfds[nfds++] = (struct pollfd){ .fd = server_fd, .events = POLLIN };
+        pthread_mutex_lock(&clients_mutex);
+        for (int i = 0; i < MAX_CLIENTS; i++) {
+            if (client_sockets[i] > 0) {
+                slot_of[nfds] = i;
+                pfds[nfds++] = (struct pollfd){ .fd = client_sockets[i], .events = POLLIN };
+            }
+        }
+        pthread_mutex_unlock(&clients_mutex);
+
+        if (poll(pfds, nfds, 500) <= 0) {
+            continue;
+        }
+
+        pthread_mutex_lock(&clients_mutex);
+        for (int k = 1; k < nfds; k++) {
+            // poll 이후 메인 루프가 끊고 슬롯을 재사용했을 수 있으므로 fd 확인
+            if ((pfds[k].revents & (POLLIN | POLLHUP | POLLERR)) && client_sockets[slot_of[k]] == pfds[k].fd) {
+                handle_client_input(slot_of[k]);
+            }
+        }
+        pthread_mutex_unlock(&clients_mutex);
+        run_admin_commands();
+
+        if (!(pfds[0].revents & POLLIN)) {
+            continue;
+        }
+
         // Ŭ���̾�Ʈ ���� ����
         if ((new_socket = accept(server_fd, (struct sockaddr*)&address, (socklen_t*)&addrlen)) < 0) {
             perror("Accept failed");
             continue; // ���� �߻� �� �ٽ� ���
         }
 
+        // 송신 버퍼 자동 확장(최대 수 MB)을 끄고 상한을 둠 -> 읽지 않는 클라이언트는 빨리 끊김
+        int sndbuf = WIFI_CLIENT_SNDBUF;
+        setsockopt(new_socket, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+
         // ����� Ŭ���̾�Ʈ�� ������ �迭�� ����
         int i;
+        pthread_mutex_lock(&clients_mutex);
         for (i = 0; i < MAX_CLIENTS; i++) {
             if (client_sockets[i] == 0) {
                 client_sockets[i] = new_socket;
-                printf(">>> Wi-Fi: New client connected. Index: %d\n", i);
+                client_rx_len[i] = 0;
+                LOG1(LOG_WIFI_CONNECTED, i);
                 break;
             }
         }
+        pthread_mutex_unlock(&clients_mutex);
 
         // �ִ� Ŭ���̾�Ʈ �� �ʰ� �� ���� �ݱ�
         if (i == MAX_CLIENTS) {
-            printf(">>> Wi-Fi: Max clients reached. Rejecting connection.\n");
+            LOG0(LOG_WIFI_REJECTED);
             close(new_socket);
         }
     }
@@ -84,6 +341,26 @@ void* wifiServerThreadFunc(void* arg) {
     return NULL;
 }
 
+// ��� ����� Ŭ���̾�Ʈ���� �޽��� ����
+static void broadcast_message(const char* message) {
+    pthread_mutex_lock(&clients_mutex);
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+        if (client_sockets[i] > 0) {
+            // 읽지 않는 클라이언트 하나 때문에 호출한 쓰레드(메인 루프)가 막히지 않도록 기다리지 않음.
+            // 송신 버퍼가 찼거나 일부만 보내졌으면 그 클라이언트는 끊음 (다시 접속해서 RESEND 로 따라잡기)
+            // MSG_NOSIGNAL: 끊긴 연결에 보내도 SIGPIPE 로 프로그램이 종료되지 않음
+            size_t len = strlen(message);
+            ssize_t sent = send(client_sockets[i], message, len, MSG_DONTWAIT | MSG_NOSIGNAL);
+            if (sent != (ssize_t)len) {
+                LOG2(LOG_WIFI_SEND_FAILED, i, sent < 0 ? errno : EAGAIN);
+                // ���� ���� �� ���� �ݰ� �ʱ�ȭ
+                drop_client(i);
+            }
+        }
+    }
+    pthread_mutex_unlock(&clients_mutex);
+}
+
 // ��� �޽��� ���� �Լ�
 void send_alert(int mode) {
     const char* message = NULL;
@@ -98,15 +375,18 @@ void send_alert(int mode) {
         return; // �ٸ� ���� �˸� ����
     }
 
-    // ��� ����� Ŭ���̾�Ʈ���� �޽��� ����
-    for (int i = 0; i < MAX_CLIENTS; i++) {
-        if (client_sockets[i] > 0) {
-            if (send(client_sockets[i], message, strlen(message), 0) < 0) {
-                perror("Send failed");
-                // ���� ���� �� ���� �ݰ� �ʱ�ȭ
-                close(client_sockets[i]);
-                client_sockets[i] = 0;
-            }
-        }
+    record_alert(mode, message);
+    broadcast_message(message);
+}
+
+// 쓰레드 상태(Watchdog) 알림 전송 함수
+void send_health_alert(const char* component, int stalled, long duration_ms) {
+    char message[128];
+    if (stalled) {
+        snprintf(message, sizeof(message), "[HEALTH] %s stalled (%ld ms)", component, duration_ms);
+    } else {
+        snprintf(message, sizeof(message), "[HEALTH] %s recovered (stall %ld ms)", component, duration_ms);
     }
+    record_alert(0, message);
+    broadcast_message(message);
 }
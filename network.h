@@ -6,5 +6,6 @@
 void init_network();
 void* wifiServerThreadFunc(void* arg);
 void send_alert(int mode);
+void send_health_alert(const char* component, int stalled, long duration_ms); // Watchdog 상태 알림
 
 #endif // NETWORK_H
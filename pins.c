@@ -0,0 +1,29 @@
+#include <time.h>
+#include <wiringPi.h>
+
+#include "pins.h"
+#include "clock.h"
+
+static void wpi_mode(int pin, int is_output) {
+    pinMode(pin, is_output ? OUTPUT : INPUT);
+}
+
+static void wpi_write(int pin, int value) {
+    digitalWrite(pin, value);
+}
+
+static int wpi_read(int pin) {
+    return digitalRead(pin);
+}
+
+static long wpi_now_us() {
+    return (long)clock_now_us();
+}
+
+static void wpi_sleep_us(long us) {
+    delayMicroseconds(us); // 트리거 펄스(10us)처럼 짧은 대기는 정밀해야 하므로 바쁜 대기 (실제 하드웨어 전용)
+}
+
+const pin_backend_t wiringpi_pins = {
+    wpi_mode, wpi_write, wpi_read, wpi_now_us, wpi_sleep_us
+};
@@ -0,0 +1,17 @@
+#ifndef PINS_H
+#define PINS_H
+
+// GPIO 접근 백엔드
+// 초음파 스케줄러처럼 타이밍이 중요한 모듈은 wiringPi 를 직접 부르지 않고
+// 이 구조체를 통해 핀을 다룹니다. (실제 하드웨어 / 시뮬레이션 교체 가능)
+typedef struct {
+    void (*mode)(int pin, int is_output);
+    void (*write)(int pin, int value);
+    int  (*read)(int pin);
+    long (*now_us)();          // 단조 증가 시각 (us)
+    void (*sleep_us)(long us);
+} pin_backend_t;
+
+extern const pin_backend_t wiringpi_pins; // 실제 하드웨어 (wiringPi)
+
+#endif // PINS_H
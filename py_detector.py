@@ -1,32 +1,60 @@
-import cv2
 import time
 import os
-import numpy as np
-from picamera2 import Picamera2 
+import signal
+from camera_pipeline import CameraPipeline
 
 # 경로 정의
 FIFO_PATH = "/tmp/opencv_fifo"
-TRIGGER_PATH = "/tmp/trigger_capture"  # [추가] C에서 보내는 촬영 신호 파일
-SAVE_PATH = "danger_capture.jpg"       # [추가] 저장될 사진 파일명
-THRESHOLD_VAL = 25
-MIN_CONTOUR_AREA = 500
+TRIGGER_PATH = "/tmp/trigger_capture"  # [추가] C에서 보내는 촬영 신호 파일 (내용: 사건 번호)
+EVIDENCE_DIR = "evidence"              # 증거 사진 저장 폴더 (카메라별 / 사건별 하위 폴더)
+EVIDENCE_MAX_BYTES = 512 * 1024 * 1024 # 저장 용량 한도 (넘으면 오래된 사진부터 삭제, 카메라 수로 나눔)
+EVIDENCE_MAX_AGE_S = 7 * 24 * 3600     # 보관 기간
+RATE_PATH = "/tmp/sentry_rate"         # [추가] C 의 Rate Governor 가 정한 프레임 속도 (fps)
+DEFAULT_FPS = 20
+CONFIG_PATH = "sentry.conf"            # [추가] 실행 중 설정 파일 (C 의 RUNTIME_CONFIG_PATH 와 같은 파일)
+
+# 카메라 목록 (카메라마다 작업 프로세스 1개, 코어 0 은 C 프로그램/부모 프로세스용으로 남김)
+# zones: (구역 번호, 시작 x 비율, 끝 x 비율) - 구역 번호는 config.h 의 RANGING_TRANSDUCERS 구역과 같음
+# 예) 문 하나에 카메라 2대: 두 번째 카메라를 {"name": "side", "source": "picam:1", "core": 2, ...} 로 추가
+# roi: 구역별 관심 영역 다각형 (화면 비율 좌표) - 하늘/벽/길거리 등 그 밖의 움직임은 무시
+#   예) "roi": [(0, [(0.30, 0.35), (0.70, 0.35), (0.85, 1.0), (0.15, 1.0)])]  # 문 앞 사다리꼴을 구역 0 으로
+CAMERAS = [
+    {"name": "front", "source": "picam:0", "core": 1, "threshold": 25, "min_blob_area": 500,
+     "zones": [(0, 0.0, 1.0)]},
+]
+
+pipeline = None
+
+# C 쪽이 감지 주기를 올리면 SIGUSR1 을 보냄 -> 대기 중이던 작업 프로세스를 바로 깨움
+def on_rate_signal(signum, frame):
+    if pipeline is not None:
+        pipeline.wake()
+
+def read_capture_trigger():
+    """트리거 파일이 있으면 사건 번호를 읽고 삭제, 없으면 None"""
+    try:
+        with open(TRIGGER_PATH) as f:
+            content = f.read().strip()
+        os.remove(TRIGGER_PATH)
+    except OSError:
+        return None
+    try:
+        return int(content)
+    except ValueError:
+        return int(time.time())  # 예전 방식(touch)으로 만든 빈 파일
 
 def run_motion_detector():
-    print("[Python] Initializing Picamera2...")
-    
-    # Picamera2 초기화
-    picam2 = Picamera2()
-    
-    # 설정: 비디오 분석용(LoRes)와 사진 촬영용(Main) 동시 구성
-    config = picam2.create_preview_configuration(
-        main={"size": (1920, 1080), "format": "BGR888"}, # 사진용 고화질
-        lores={"size": (640, 480), "format": "YUV420"},  # 분석용 저화질
-        queue=False
-    )
-    picam2.configure(config)
-    picam2.start()
-    
-    print("[Python] Picamera2 started successfully.")
+    global pipeline
+    t0 = time.monotonic()
+    # 첫 결과를 보내기 전에 핸들러를 설치해야 함 (C 는 첫 결과 수신 후에만 신호를 보냄)
+    signal.signal(signal.SIGUSR1, on_rate_signal)
+    print(f"[Python] Starting {len(CAMERAS)} camera worker(s)...")
+
+    # 카메라마다 작업 프로세스 (Picamera2 초기화 / 감지 / 증거 사진 기록은 각 프로세스 안에서)
+    pipeline = CameraPipeline(CAMERAS, rate_path=RATE_PATH, default_fps=DEFAULT_FPS,
+                              evidence_dir=EVIDENCE_DIR, evidence_max_bytes=EVIDENCE_MAX_BYTES,
+                              evidence_max_age_s=EVIDENCE_MAX_AGE_S, config_path=CONFIG_PATH)
+    pipeline.start()
 
     # FIFO 파일 열기
     try:
@@ -34,77 +62,42 @@ def run_motion_detector():
         print(f"[Python] Opened FIFO pipe: {FIFO_PATH}")
     except Exception as e:
         print(f"[Python] ERROR opening pipe: {e}")
-        picam2.stop()
+        pipeline.stop()
         return
 
-    time.sleep(2) 
-    
-    # 초기 프레임 (분석용 lores 스트림 사용)
-    prev_frame = picam2.capture_array("lores")
-    gray_prev = cv2.cvtColor(prev_frame, cv2.COLOR_YUV2GRAY_I420)
-    
-    print("[Python] Motion Detector Running... (Waiting for capture trigger)")
-
+    first = True
     try:
         while True:
-           # === [수정된 로직] 촬영 트리거 파일 확인 ===
-            if os.path.exists(TRIGGER_PATH):
-                print(">>> [Python] Capture Trigger received! Taking photo...")
-                
-                # [추가됨] 기존 사진 파일이 있다면 먼저 삭제 (권한 충돌 방지)
-                if os.path.exists(SAVE_PATH):
-                    try:
-                        os.remove(SAVE_PATH)
-                        print(">>> [Python] Old file removed.")
-                    except Exception as e:
-                        print(f">>> [Python] Failed to remove old file: {e}")
-
-                try:
-                    # 사진 촬영 및 저장
-                    picam2.capture_file(SAVE_PATH) 
-                    print(f">>> [Python] Saved to {SAVE_PATH}")
-                    
-                    # [추가됨] 저장된 파일의 권한을 '누구나 읽기/쓰기 가능'하게 변경 (chmod 666)
-                    os.chmod(SAVE_PATH, 0o666)
-                    
-                except Exception as e:
-                    print(f">>> [Python] Capture failed: {e}")
-                
-                # 트리거 파일 삭제
-                try:
-                    os.remove(TRIGGER_PATH)
-                except:
-                    pass
-            # ==========================================
-
-            # 실시간 움직임 감지 (lores 스트림 사용)
-            current_frame = picam2.capture_array("lores")
-            gray_current = cv2.cvtColor(current_frame, cv2.COLOR_YUV2GRAY_I420)
-            
-            diff = cv2.absdiff(gray_prev, gray_current)
-            _, thresh = cv2.threshold(diff, THRESHOLD_VAL, 255, cv2.THRESH_BINARY)
-            thresh = cv2.dilate(thresh, None, iterations=2)
-            contours, _ = cv2.findContours(thresh, cv2.RETR_EXTERNAL, cv2.CHAIN_APPROX_SIMPLE)
-
-            motion_detected = False
-            for contour in contours:
-                if cv2.contourArea(contour) > MIN_CONTOUR_AREA:
-                    motion_detected = True
-                    break
+            # === 촬영 트리거 확인 === (모든 카메라가 다음 프레임에서 사진용 프레임을 같이 꺼냄)
+            incident = read_capture_trigger()
+            if incident is not None:
+                pipeline.request_capture(incident)
+                print(f">>> [Python] Capture requested (incident {incident})")
 
-            if motion_detected:
-                os.write(fifo_fd, b'1')
+            # 카메라 결과 1개가 올 때마다 구역별 상태를 합쳐서 전달
+            # "M<16진수>\n": bit n = 구역 n 에 추적 중인 대상 존재 (멈춰 있어도 유지)
+            # "V<16진수>\n": 이번 프레임에 실제로 움직인 구역 (있을 때만, C 는 이것이 끊기면 경보 유지를 풂)
+            result = pipeline.next_result(timeout=1.0)
+            if result is None:
+                continue
+            zone_mask, motion_mask, _ = result
+            if motion_mask:
+                os.write(fifo_fd, b"M%x\nV%x\n" % (zone_mask, motion_mask))
             else:
-                os.write(fifo_fd, b'0')
+                os.write(fifo_fd, b"M%x\n" % zone_mask)
 
-            gray_prev = gray_current
-            time.sleep(0.05) 
+            if first:
+                print(f"[Python] Motion Detector Running... first result at +{(time.monotonic() - t0) * 1000:.1f} ms")
+                first = False
             
     except KeyboardInterrupt:
         print("\n[Python] Detector stopped.")
     finally:
-        picam2.stop()
+        signal.signal(signal.SIGINT, signal.SIG_IGN)  # 정리(증거 사진 기록 마무리) 중에는 다시 끊기지 않도록
+        pipeline.stop()
         os.close(fifo_fd)
+        for name, frames, busy in pipeline.stats():
+            print(f"[Python] {name}: {frames} frames, {busy * 1000 / max(1, frames):.1f} ms/frame")
 
 if __name__ == "__main__":
-    run_motion_detector()
\ No newline at end of file
+    run_motion_detector()
@@ -0,0 +1,282 @@
+#include <stdio.h>
+#include <pthread.h>
+
+#include "config.h"
+#include "ranging.h"
+
+#define RANGING_RISE_TIMEOUT_US 5000   // 트리거 후 에코 핀이 올라오지 않으면 실패
+#define US_TO_CM                0.017  // 음속 34000cm/s 왕복 -> 17000cm/s
+#define RANGING_QUIET_US        40000  // 재확인 전 완전한 정적 (HC-SR04 최대 에코 38ms 이상)
+#define RANGING_HOLDOFF_MAX_US  (RANGING_HOLDOFF_US * 4)
+
+typedef struct {
+    transducer_cfg_t cfg;
+    double dist;      // 확정된 거리 (cm, -1: 범위 내 물체 없음)
+    long dist_us;     // 확정 시각 (0: 아직 없음)
+    double pending;   // 단독 재확인 대기 중인 값
+    int xtalk_count;  // 재확인에서 크로스토크로 판정된 횟수
+} transducer_t;
+
+static const pin_backend_t* pins;
+static transducer_t tr[MAX_TRANSDUCERS];
+static int tr_count = 0;
+static int last_group = -1;        // 마지막으로 발사한 그룹 (라운드 로빈)
+static int verify_idx = -1;        // 다음 사이클에 단독 발사로 재확인할 센서
+static int next_free_group = 0;    // 단독 그룹 분리 시 사용할 새 그룹 번호
+static long last_cycle_end_us = 0;
+static long holdoff_us = RANGING_HOLDOFF_US; // 그룹 간 대기 (이전 그룹 잔향 크로스토크 시 증가)
+static zone_reading_t zones[MAX_ZONES];
+static ranging_stats_t stats;
+static pthread_mutex_t ranging_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+int init_ranging(const pin_backend_t* backend, const transducer_cfg_t* cfg, int count) {
+    if (count > MAX_TRANSDUCERS) count = MAX_TRANSDUCERS;
+
+    pins = backend;
+    tr_count = 0;
+    next_free_group = 0;
+    for (int i = 0; i < count; i++) {
+        if (cfg[i].zone < 0 || cfg[i].zone >= MAX_ZONES) {
+            fprintf(stderr, "[Ranging] Transducer %d has invalid zone %d\n", i, cfg[i].zone);
+            return -1;
+        }
+        tr[i].cfg = cfg[i];
+        tr[i].dist = -1;
+        tr[i].dist_us = 0;
+        tr[i].pending = -1;
+        tr[i].xtalk_count = 0;
+        if (cfg[i].group >= next_free_group) next_free_group = cfg[i].group + 1;
+
+        pins->mode(cfg[i].trig_pin, 1);
+        pins->mode(cfg[i].echo_pin, 0);
+        pins->write(cfg[i].trig_pin, 0);
+        tr_count++;
+    }
+    for (int z = 0; z < MAX_ZONES; z++) {
+        zones[z].dist = -1;
+        zones[z].t_us = 0;
+        zones[z].seq = 0;
+    }
+    last_group = -1;
+    verify_idx = -1;
+    holdoff_us = RANGING_HOLDOFF_US;
+    return 0;
+}
+
+// 라운드 로빈: 마지막 그룹보다 큰 번호 중 가장 작은 그룹, 없으면 처음으로
+static int pick_next_group() {
+    int next = -1, lowest = -1;
+    for (int i = 0; i < tr_count; i++) {
+        int g = tr[i].cfg.group;
+        if (lowest == -1 || g < lowest) lowest = g;
+        if (g > last_group && (next == -1 || g < next)) next = g;
+    }
+    return (next == -1) ? lowest : next;
+}
+
+// 그룹을 동시에 발사하고 모든 에코를 한 번의 폴링 루프에서 측정
+// out[k]: 거리(cm), -1: 에코 없음, -2: 에코 핀이 아직 HIGH 라 이번에는 건너뜀
+static void measure_group(const int* members, int n, double* out) {
+    long rise[MAX_TRANSDUCERS];
+    int state[MAX_TRANSDUCERS]; // 0: 상승 대기, 1: 에코 중, 2: 완료
+    int remaining = 0;
+
+    for (int k = 0; k < n; k++) {
+        out[k] = -1;
+        // 이전 에코가 아직 끝나지 않은 센서는 잘못된 상승 시각을 잡게 되므로 제외
+        if (pins->read(tr[members[k]].cfg.echo_pin) == 1) {
+            out[k] = -2;
+            state[k] = 2;
+        } else {
+            state[k] = 0;
+            remaining++;
+        }
+    }
+
+    // 트리거: LOW 2us -> HIGH 10us -> LOW (그룹 전체 동시)
+    for (int k = 0; k < n; k++) if (state[k] == 0) pins->write(tr[members[k]].cfg.trig_pin, 0);
+    pins->sleep_us(2);
+    for (int k = 0; k < n; k++) if (state[k] == 0) pins->write(tr[members[k]].cfg.trig_pin, 1);
+    pins->sleep_us(10);
+    for (int k = 0; k < n; k++) if (state[k] == 0) pins->write(tr[members[k]].cfg.trig_pin, 0);
+
+    long start = pins->now_us();
+    while (remaining > 0) {
+        long now = pins->now_us();
+        for (int k = 0; k < n; k++) {
+            if (state[k] == 2) continue;
+            int level = pins->read(tr[members[k]].cfg.echo_pin);
+
+            if (state[k] == 0) {
+                if (level == 1) {
+                    rise[k] = now;
+                    state[k] = 1;
+                } else if (now - start > RANGING_RISE_TIMEOUT_US) {
+                    state[k] = 2;
+                    remaining--;
+                }
+            } else {
+                if (level == 0) {
+                    out[k] = (now - rise[k]) * US_TO_CM;
+                    state[k] = 2;
+                    remaining--;
+                } else if (now - rise[k] > RANGING_ECHO_TIMEOUT_US) {
+                    state[k] = 2; // 범위 밖 (에코 없음)
+                    remaining--;
+                }
+            }
+        }
+    }
+}
+
+// ranging_mutex 를 잡은 상태에서 호출
+static void update_zone_locked(int zone, long now) {
+    double nearest = -1;
+    for (int i = 0; i < tr_count; i++) {
+        if (tr[i].cfg.zone != zone || tr[i].dist < 0) continue;
+        if ((now - tr[i].dist_us) / 1000 > RANGING_STALE_MS) continue;
+        if (nearest < 0 || tr[i].dist < nearest) nearest = tr[i].dist;
+    }
+    zones[zone].dist = nearest;
+    zones[zone].t_us = now;
+    zones[zone].seq++;
+}
+
+static int group_size(int group) {
+    int n = 0;
+    for (int i = 0; i < tr_count; i++) {
+        if (tr[i].cfg.group == group) n++;
+    }
+    return n;
+}
+
+int ranging_cycle() {
+    int members[MAX_TRANSDUCERS];
+    double result[MAX_TRANSDUCERS];
+    int n = 0;
+    int solo = (verify_idx >= 0);
+
+    if (tr_count == 0) return 0;
+
+    if (solo) {
+        members[n++] = verify_idx;
+    } else {
+        int g = pick_next_group();
+        for (int i = 0; i < tr_count; i++) {
+            if (tr[i].cfg.group == g) members[n++] = i;
+        }
+        last_group = g;
+    }
+
+    // 이전 사이클의 잔향이 사라질 때까지 대기
+    // (재확인은 어떤 발사음도 남아 있지 않은 완전한 정적 상태에서)
+    long wait = last_cycle_end_us + (solo ? RANGING_QUIET_US : holdoff_us) - pins->now_us();
+    if (last_cycle_end_us != 0 && wait > 0) pins->sleep_us(wait);
+
+    measure_group(members, n, result);
+    long now = pins->now_us();
+    last_cycle_end_us = now;
+
+    int accepted = 0;
+    int touched[MAX_ZONES] = {0};
+
+    pthread_mutex_lock(&ranging_mutex);
+    stats.cycles++;
+    for (int k = 0; k < n; k++) {
+        transducer_t* t = &tr[members[k]];
+        double d = result[k];
+        if (d == -2) continue;
+        stats.fired++;
+        if (d < 0) stats.timeouts++;
+
+        if (solo) {
+            // 정적 상태의 단독 발사는 크로스토크가 없으므로 그대로 확정, 보류했던 값과 비교해 판정
+            verify_idx = -1;
+            if (t->pending >= 0 && (d < 0 || t->pending < d - RANGING_XTALK_CM / 2)) {
+                stats.crosstalk++;
+                if (++t->xtalk_count >= RANGING_XTALK_LIMIT) {
+                    t->xtalk_count = 0;
+                    if (group_size(t->cfg.group) > 1) {
+                        // 같이 발사하는 센서의 소리 -> 단독 그룹으로 분리
+                        printf("[Ranging] Transducer on Trig %d hears its group -> own group %d\n",
+                               t->cfg.trig_pin, next_free_group);
+                        t->cfg.group = next_free_group++;
+                        stats.regroups++;
+                    } else if (holdoff_us < RANGING_HOLDOFF_MAX_US) {
+                        // 이미 혼자 발사 중 -> 이전 그룹의 잔향이 늦게 도착하는 것, 대기 시간 증가
+                        holdoff_us += RANGING_HOLDOFF_US;
+                        printf("[Ranging] Late echoes on Trig %d -> group holdoff %ld us\n",
+                               t->cfg.trig_pin, holdoff_us);
+                    }
+                }
+            }
+        }
+        else if (d >= 0 && (t->dist < 0 || d < t->dist - RANGING_XTALK_CM)) {
+            // 갑자기 가까워짐 -> 다음 사이클에 정적 상태에서 단독으로 재확인 (이번 값은 보류)
+            // 다른 센서가 재확인 중이면 이번 값은 버리고 다음 사이클에 다시 측정
+            if (verify_idx < 0) {
+                t->pending = d;
+                verify_idx = members[k];
+            }
+            continue;
+        }
+
+        t->dist = d;
+        t->dist_us = now;
+        touched[t->cfg.zone] = 1;
+        if (d >= 0) accepted++;
+    }
+    stats.accepted += accepted;
+    for (int z = 0; z < MAX_ZONES; z++) {
+        if (touched[z]) update_zone_locked(z, now);
+    }
+    pthread_mutex_unlock(&ranging_mutex);
+
+    return accepted;
+}
+
+int ranging_get_zone(int zone, zone_reading_t* out) {
+    if (zone < 0 || zone >= MAX_ZONES) return -1;
+    pthread_mutex_lock(&ranging_mutex);
+    *out = zones[zone];
+    pthread_mutex_unlock(&ranging_mutex);
+    return 0;
+}
+
+double ranging_nearest() {
+    return ranging_nearest_in(~0u);
+}
+
+double ranging_nearest_in(unsigned int zone_mask) {
+    double nearest = -1;
+    long now = pins ? pins->now_us() : 0;
+
+    pthread_mutex_lock(&ranging_mutex);
+    for (int z = 0; z < MAX_ZONES; z++) {
+        if (!(zone_mask & (1u << z))) continue;
+        if (zones[z].dist < 0 || (now - zones[z].t_us) / 1000 > RANGING_STALE_MS) continue;
+        if (nearest < 0 || zones[z].dist < nearest) nearest = zones[z].dist;
+    }
+    pthread_mutex_unlock(&ranging_mutex);
+    return nearest;
+}
+
+unsigned int ranging_covered_zones() {
+    unsigned int mask = 0;
+    pthread_mutex_lock(&ranging_mutex);
+    for (int i = 0; i < tr_count; i++) {
+        mask |= 1u << tr[i].cfg.zone;
+    }
+    pthread_mutex_unlock(&ranging_mutex);
+    return mask;
+}
+
+long ranging_now_us() {
+    return pins ? pins->now_us() : 0;
+}
+
+void ranging_get_stats(ranging_stats_t* out) {
+    pthread_mutex_lock(&ranging_mutex);
+    *out = stats;
+    pthread_mutex_unlock(&ranging_mutex);
+}
@@ -0,0 +1,44 @@
+#ifndef RANGING_H
+#define RANGING_H
+
+#include "pins.h"
+
+// 다중 초음파 센서 스케줄러 (Ranging Scheduler)
+// - 같은 그룹의 센서는 동시에 발사하고 에코를 한 번의 폴링 루프에서 함께 측정
+//   -> 센서 수가 늘어도 그룹 수만큼만 주기가 늘어남
+// - 그룹 사이에는 잔향이 사라질 때까지 대기 (RANGING_HOLDOFF_US)
+// - 갑자기 가까워진 값은 단독 발사로 재확인하여 크로스토크를 걸러내고,
+//   반복되면 해당 센서를 단독 그룹으로 분리
+
+typedef struct {
+    int trig_pin;
+    int echo_pin;
+    int zone;   // 구역 번호 (0 ~ MAX_ZONES-1)
+    int group;  // 발사 그룹 (같은 그룹끼리 동시 발사)
+} transducer_cfg_t;
+
+typedef struct {
+    double dist;        // 구역 내 최근접 거리 (cm, -1: 유효한 측정 없음)
+    long t_us;          // 측정 시각
+    unsigned long seq;  // 구역 값이 갱신될 때마다 증가
+} zone_reading_t;
+
+typedef struct {
+    unsigned long cycles;    // 발사 횟수 (그룹 단위)
+    unsigned long fired;     // 센서별 발사 합계
+    unsigned long accepted;  // 확정된 측정
+    unsigned long timeouts;  // 에코 없음
+    unsigned long crosstalk; // 재확인에서 걸러진 측정
+    unsigned long regroups;  // 단독 그룹으로 분리된 횟수
+} ranging_stats_t;
+
+int    init_ranging(const pin_backend_t* pins, const transducer_cfg_t* cfg, int count);
+int    ranging_cycle();               // 그룹 하나 발사 + 결과 반영 (확정된 측정 수 반환)
+int    ranging_get_zone(int zone, zone_reading_t* out);
+double ranging_nearest();             // 모든 구역 중 최근접 거리 (-1: 없음)
+double ranging_nearest_in(unsigned int zone_mask); // 지정한 구역들(bit n: 구역 n) 중 최근접 거리
+unsigned int ranging_covered_zones(); // 초음파 센서가 하나라도 있는 구역 (bit n: 구역 n)
+void   ranging_get_stats(ranging_stats_t* out);
+long   ranging_now_us();              // zone_reading_t.t_us 와 같은 기준의 현재 시각
+
+#endif // RANGING_H
@@ -0,0 +1,104 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "config.h"
+#include "ranging.h"
+#include "sim_pins.h"
+
+// =========================================================
+// 초음파 스케줄러 시뮬레이션 (하드웨어 없이 실행)
+// =========================================================
+// 사용법: ./ranging_sim [-n 센서수(2~8, 짝수)] [-s 가상 초] [-x (크로스토크 주입 안 함)]
+//
+// 센서 2개씩 한 구역을 맡고, 각 구역의 첫 번째 센서는 그룹 0, 두 번째는 그룹 1 로 발사합니다.
+// 구역 0 에는 300cm 벽, 나머지 구역에는 250cm -> 40cm 로 다가오는 사람이 있습니다.
+// 크로스토크 주입:
+//   - 같은 그룹 (센서 0 -> 센서 2, 약 51cm 에 해당하는 지연)
+//   - 이전 그룹의 잔향 (센서 1 -> 센서 0, 30ms 후 도착)
+
+int main(int argc, char* argv[]) {
+    int count = 4;
+    double seconds = 10.0;
+    int inject = 1;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) count = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) seconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "-x") == 0) inject = 0;
+    }
+    if (count < 2 || count > MAX_TRANSDUCERS || count % 2 != 0 || count / 2 > MAX_ZONES) {
+        fprintf(stderr, "Transducer count must be even, 2..%d\n", MAX_TRANSDUCERS);
+        return 1;
+    }
+
+    transducer_cfg_t cfg[MAX_TRANSDUCERS];
+    for (int i = 0; i < count; i++) {
+        cfg[i].trig_pin = 100 + i; // 가상 핀 번호
+        cfg[i].echo_pin = 200 + i;
+        cfg[i].zone = i / 2;
+        cfg[i].group = i % 2;
+    }
+
+    sim_pins_init(cfg, count);
+    if (init_ranging(&sim_pins, cfg, count) != 0) return 1;
+
+    if (inject && count >= 4) {
+        sim_set_crosstalk(0, 2, 3000);
+        sim_set_crosstalk(1, 0, 30000);
+    }
+
+    clock_t cpu_start = clock();
+    long end_us = (long)(seconds * 1e6);
+    long next_print = 0;
+    unsigned long last_seq[MAX_ZONES] = {0};
+    unsigned long zone_updates = 0;
+
+    printf("%8s", "t(ms)");
+    for (int z = 0; z < count / 2; z++) printf("   zone%d(cm)", z);
+    printf("\n");
+
+    while (sim_now_us() < end_us) {
+        // 목표물 이동 (구역 0: 고정 벽, 그 외: 접근하는 사람)
+        double progress = (double)sim_now_us() / end_us;
+        for (int i = 0; i < count; i++) {
+            sim_set_target(i, (i / 2 == 0) ? 300.0 : 250.0 - 210.0 * progress);
+        }
+
+        ranging_cycle();
+
+        for (int z = 0; z < count / 2; z++) {
+            zone_reading_t r;
+            ranging_get_zone(z, &r);
+            if (r.seq != last_seq[z]) {
+                zone_updates++;
+                last_seq[z] = r.seq;
+            }
+        }
+
+        if (sim_now_us() >= next_print) {
+            printf("%8.0f", sim_now_us() / 1000.0);
+            for (int z = 0; z < count / 2; z++) {
+                zone_reading_t r;
+                ranging_get_zone(z, &r);
+                printf(" %11.1f", r.dist);
+            }
+            printf("\n");
+            next_print += 500000;
+        }
+    }
+
+    ranging_stats_t s;
+    ranging_get_stats(&s);
+    double cpu_ms = (clock() - cpu_start) * 1000.0 / CLOCKS_PER_SEC;
+
+    printf("\n--- %d transducers, %.1f s simulated in %.1f ms CPU ---\n", count, seconds, cpu_ms);
+    printf("cycles            : %lu (%.1f/s)\n", s.cycles, s.cycles / seconds);
+    printf("readings accepted : %lu (%.1f/s aggregate)\n", s.accepted, s.accepted / seconds);
+    printf("zone updates      : %lu\n", zone_updates);
+    printf("timeouts          : %lu\n", s.timeouts);
+    printf("crosstalk rejected: %lu\n", s.crosstalk);
+    printf("regroups          : %lu\n", s.regroups);
+    return 0;
+}
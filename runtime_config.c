@@ -0,0 +1,504 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <errno.h>
+#include <limits.h>
+#include <poll.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/inotify.h>
+
+#include "config.h"
+#include "runtime_config.h"
+#include "log.h"
+#include "clock.h"
+
+#define RCFG_RETAIN     8     // 돌려 쓰는 스냅샷 수 (모두 사용 중이면 쓰는 쪽이 빌 때까지 기다림)
+#define RCFG_FILE_MAX   4096
+
+static const runtime_config_t default_cfg = {
+    .version = 1,
+    .dist_danger = DIST_DANGER,
+    .pir_hold_ms = PIR_HOLD_MS,
+    .rate = {
+        //               main  display buzzer  fps
+        [RATE_IDLE]   = { 250,  1000,   500,    2 },
+        [RATE_NORMAL] = { 100,   500,   200,   10 },
+        [RATE_ACTIVE] = {  50,   200,   100,   20 },
+    },
+    .auth_password = AUTH_PASSWORD,
+    .admin_password = ADMIN_PASSWORD,
+    .reason = "boot",
+};
+
+static runtime_config_t slots[RCFG_RETAIN];
+static int slot_refs[RCFG_RETAIN];        // 슬롯별 읽는 쪽 수 (rcfg_acquire ~ rcfg_release)
+static int next_slot = 0;
+static const runtime_config_t* current = &default_cfg;
+static pthread_mutex_t publish_mutex = PTHREAD_MUTEX_INITIALIZER; // 쓰는 쪽(감시 쓰레드/BT/TCP)끼리만
+static char config_path[PATH_MAX];
+static struct timespec loaded_mtime;      // 마지막으로 읽은 파일의 수정 시각
+static volatile unsigned int applied_version = 1;
+static void (*change_hook)() = NULL;
+
+static const char* role_keys[GOV_ROLES] = { "main_loop_ms", "display_ms", "buzzer_ms", "detector_fps" };
+
+long long rcfg_now_ns() {
+    return clock_now_ns();
+}
+
+// 현재 스냅샷을 잡음 (락 없음)
+// 참조 수를 올린 뒤 아직 현재 스냅샷인지 다시 확인 -> 그 사이 교체/재사용된 슬롯은 내용을 보기 전에 놓고 재시도
+// 쓰는 쪽은 현재가 아니고 참조 수가 0 인 슬롯만 덮어쓰므로, 잡은 동안에는 절대 바뀌지 않음
+const runtime_config_t* rcfg_acquire() {
+    while (1) {
+        const runtime_config_t* c = __atomic_load_n(&current, __ATOMIC_SEQ_CST);
+        if (c == &default_cfg) return c; // 기본값은 덮어쓰지 않음
+        int* ref = &slot_refs[c - slots];
+        __atomic_add_fetch(ref, 1, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&current, __ATOMIC_SEQ_CST) == c) return c;
+        __atomic_sub_fetch(ref, 1, __ATOMIC_SEQ_CST);
+    }
+}
+
+void rcfg_release(const runtime_config_t* c) {
+    if (c == &default_cfg) return;
+    __atomic_sub_fetch(&slot_refs[c - slots], 1, __ATOMIC_SEQ_CST);
+}
+
+unsigned int rcfg_version() {
+    const runtime_config_t* c = rcfg_acquire();
+    unsigned int v = c->version;
+    rcfg_release(c);
+    return v;
+}
+
+int rcfg_pir_hold_ms() {
+    const runtime_config_t* c = rcfg_acquire();
+    int v = c->pir_hold_ms;
+    rcfg_release(c);
+    return v;
+}
+
+int rcfg_rate(int level, int role) {
+    const runtime_config_t* c = rcfg_acquire();
+    int v = c->rate[level][role];
+    rcfg_release(c);
+    return v;
+}
+
+// Python Detector 가 읽는 항목 (camera_pipeline.py 의 DETECTOR_KEYS) - C 는 검증만
+// "detector_threshold.front" 처럼 카메라 이름을 붙일 수 있음
+static const struct {
+    const char* key;
+    long max;
+} detector_keys[] = {
+    { "detector_threshold", 255 },
+    { "detector_min_blob_area", 640 * 480 },
+};
+
+static int check_detector_key(const char* key, const char* value, char* err, int err_len) {
+    size_t base_len = strcspn(key, ".");
+    const char* cam = key[base_len] == '.' ? key + base_len + 1 : NULL;
+    if (cam && (*cam == '\0' || strspn(cam, "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_-") != strlen(cam))) {
+        snprintf(err, err_len, "bad camera name in '%s'", key);
+        return -1;
+    }
+    for (size_t i = 0; i < sizeof(detector_keys) / sizeof(detector_keys[0]); i++) {
+        if (strlen(detector_keys[i].key) != base_len || strncmp(key, detector_keys[i].key, base_len) != 0) continue;
+        // Python 은 int() 로 읽으므로 부호 없는 10진수만 허용
+        char* end;
+        long v = strtol(value, &end, 10);
+        if (*value < '0' || *value > '9' || *end != '\0' || v < 1 || v > detector_keys[i].max) {
+            snprintf(err, err_len, "%s must be an integer 1..%ld", detector_keys[i].key, detector_keys[i].max);
+            return -1;
+        }
+        return 0;
+    }
+    snprintf(err, err_len, "unknown key '%s'", key);
+    return -1;
+}
+
+// "key = value" 한 줄을 후보 스냅샷에 반영 (0: 성공)
+static int apply_key(runtime_config_t* c, const char* key, const char* value, char* err, int err_len) {
+    char* end;
+
+    if (strcmp(key, "dist_danger") == 0) {
+        double v = strtod(value, &end);
+        if (end == value || v <= 0 || v > 400) {
+            snprintf(err, err_len, "dist_danger must be 0..400 cm");
+            return -1;
+        }
+        c->dist_danger = v;
+        return 0;
+    }
+    if (strcmp(key, "pir_hold_ms") == 0) {
+        long v = strtol(value, &end, 10);
+        if (end == value || v < 0 || v > 600000) {
+            snprintf(err, err_len, "pir_hold_ms must be 0..600000");
+            return -1;
+        }
+        c->pir_hold_ms = (int)v;
+        return 0;
+    }
+    for (int role = 0; role < GOV_ROLES; role++) {
+        if (strcmp(key, role_keys[role]) != 0) continue;
+        // "IDLE, NORMAL, ACTIVE" 순서의 3개 값
+        int v[RATE_LEVELS];
+        const char* p = value;
+        for (int lv = 0; lv < RATE_LEVELS; lv++) {
+            long x = strtol(p, &end, 10);
+            if (end == p || x < 1 || x > 10000) {
+                snprintf(err, err_len, "%s needs %d values 1..10000 (idle, normal, active)", key, RATE_LEVELS);
+                return -1;
+            }
+            v[lv] = (int)x;
+            p = end;
+            while (*p == ',' || *p == ' ' || *p == '\t') p++;
+        }
+        for (int lv = 0; lv < RATE_LEVELS; lv++) c->rate[lv][role] = v[lv];
+        return 0;
+    }
+    if (strcmp(key, "auth_password") == 0 || strcmp(key, "admin_password") == 0) {
+        if (strlen(value) == 0 || strlen(value) >= RCFG_PASSWORD_LEN) {
+            snprintf(err, err_len, "%s must be 1..%d characters", key, RCFG_PASSWORD_LEN - 1);
+            return -1;
+        }
+        strcpy(key[1] == 'u' ? c->auth_password : c->admin_password, value);
+        return 0;
+    }
+    if (strncmp(key, "detector_", 9) == 0) {
+        return check_detector_key(key, value, err, err_len);
+    }
+    snprintf(err, err_len, "unknown key '%s'", key);
+    return -1;
+}
+
+// 설정 파일 내용 전체를 기본값 위에 적용 (하나라도 틀리면 전체 거부)
+static int parse_config(const char* text, runtime_config_t* c, char* err, int err_len) {
+    char line[256];
+    int line_no = 0;
+
+    *c = default_cfg;
+    while (*text) {
+        size_t len = strcspn(text, "\n");
+        if (len >= sizeof(line)) len = sizeof(line) - 1;
+        memcpy(line, text, len);
+        line[len] = '\0';
+        text += strcspn(text, "\n");
+        if (*text == '\n') text++;
+        line_no++;
+
+        char* hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+        char* eq = strchr(line, '=');
+        if (eq == NULL) {
+            if (strspn(line, " \t\r") != strlen(line)) {
+                snprintf(err, err_len, "line %d: expected 'key = value'", line_no);
+                return -1;
+            }
+            continue;
+        }
+
+        // 앞뒤 공백 제거
+        *eq = '\0';
+        char* key = line + strspn(line, " \t");
+        char* value = eq + 1 + strspn(eq + 1, " \t");
+        for (char* e = key + strlen(key); e > key && strchr(" \t", e[-1]); ) *--e = '\0';
+        for (char* e = value + strlen(value); e > value && strchr(" \t\r", e[-1]); ) *--e = '\0';
+
+        char key_err[128];
+        if (apply_key(c, key, value, key_err, sizeof(key_err)) != 0) {
+            snprintf(err, err_len, "line %d: %s", line_no, key_err);
+            return -1;
+        }
+    }
+
+    // 항목 사이의 관계 검증
+    for (int role = 0; role < GOV_ROLES; role++) {
+        int faster_is_smaller = (role != GOV_DETECTOR_FPS);
+        for (int lv = 1; lv < RATE_LEVELS; lv++) {
+            int prev = c->rate[lv - 1][role], cur = c->rate[lv][role];
+            if (faster_is_smaller ? cur > prev : cur < prev) {
+                snprintf(err, err_len, "%s: ACTIVE must not be slower than IDLE/NORMAL", role_keys[role]);
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+static int read_file(const char* path, char* buf, int size, struct timespec* mtime) {
+    struct stat st;
+    FILE* fp = fopen(path, "r");
+    if (fp == NULL) return -1;
+    if (fstat(fileno(fp), &st) == 0 && mtime) *mtime = st.st_mtim;
+    int n = fread(buf, 1, size - 1, fp);
+    buf[n] = '\0';
+    fclose(fp);
+    return n;
+}
+
+// 덮어써도 되는 슬롯: 현재 스냅샷이 아니고 잡고 있는 읽는 쪽이 없음
+// 모두 사용 중이면 하나가 풀릴 때까지 대기 (읽는 쪽은 길어야 메인 루프 한 바퀴 동안만 잡음)
+static runtime_config_t* free_slot_locked() {
+    int waited_ms = 0;
+    while (1) {
+        for (int n = 0; n < RCFG_RETAIN; n++) {
+            int i = (next_slot + n) % RCFG_RETAIN;
+            if (&slots[i] != current && __atomic_load_n(&slot_refs[i], __ATOMIC_SEQ_CST) == 0) {
+                next_slot = (i + 1) % RCFG_RETAIN;
+                return &slots[i];
+            }
+        }
+        if (waited_ms == 1000) {
+            printf(">>> [Config] All %d snapshots still in use after 1 s, waiting...\n", RCFG_RETAIN);
+        }
+        clock_sleep_ms(1);
+        waited_ms++;
+    }
+}
+
+// 검증이 끝난 후보를 빈 슬롯에 복사하고 포인터 교체 (publish_mutex 보유 상태에서 호출)
+static void publish_locked(const runtime_config_t* candidate, const char* reason, long long changed_ns) {
+    const runtime_config_t* old = current;
+    runtime_config_t* slot = free_slot_locked();
+
+    *slot = *candidate;
+    slot->version = old->version + 1;
+    snprintf(slot->reason, sizeof(slot->reason), "%s", reason);
+    slot->changed_ns = changed_ns;
+    slot->published_ns = rcfg_now_ns();
+    __atomic_store_n(&current, slot, __ATOMIC_RELEASE);
+
+    printf(">>> [Config] v%u published (%s): danger %.1f cm, PIR hold %d ms, main loop %d/%d/%d ms\n",
+           slot->version, reason, slot->dist_danger, slot->pir_hold_ms,
+           slot->rate[RATE_IDLE][GOV_MAIN_LOOP], slot->rate[RATE_NORMAL][GOV_MAIN_LOOP],
+           slot->rate[RATE_ACTIVE][GOV_MAIN_LOOP]);
+
+    // 새 주기가 바로 적용되도록 잠든 쓰레드를 깨움 (메인: governor_config_changed)
+    if (change_hook) change_hook();
+}
+
+void rcfg_on_change(void (*hook)()) {
+    change_hook = hook;
+}
+
+int rcfg_init(const char* path) {
+    snprintf(config_path, sizeof(config_path), "%s", path);
+    if (access(path, F_OK) != 0) {
+        printf(">>> [Config] %s not found, using built-in defaults.\n", path);
+        return 0;
+    }
+    return rcfg_reload("boot", rcfg_now_ns());
+}
+
+int rcfg_reload(const char* reason, long long changed_ns) {
+    char text[RCFG_FILE_MAX], err[160];
+    struct timespec mtime = { 0, 0 };
+    runtime_config_t candidate;
+
+    pthread_mutex_lock(&publish_mutex);
+    if (read_file(config_path, text, sizeof(text), &mtime) < 0) {
+        pthread_mutex_unlock(&publish_mutex);
+        printf(">>> [Config] Reload failed: cannot read %s\n", config_path);
+        return -1;
+    }
+    loaded_mtime = mtime; // 틀린 파일이어도 같은 내용으로 계속 다시 읽지 않도록
+    if (parse_config(text, &candidate, err, sizeof(err)) != 0) {
+        pthread_mutex_unlock(&publish_mutex);
+        printf(">>> [Config] Rejected %s (%s), keeping v%u: %s\n", config_path, reason, rcfg_version(), err);
+        return -1;
+    }
+    publish_locked(&candidate, reason, changed_ns);
+    pthread_mutex_unlock(&publish_mutex);
+    return 0;
+}
+
+static void fsync_parent_dir(const char* path) {
+    char dir[PATH_MAX];
+    const char* slash = strrchr(path, '/');
+    if (slash) {
+        snprintf(dir, sizeof(dir), "%.*s", (int)(slash - path), path);
+    } else {
+        snprintf(dir, sizeof(dir), ".");
+    }
+    int fd = open(dir, O_RDONLY | O_DIRECTORY);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+}
+
+int rcfg_set(const char* key, const char* value, const char* reason, char* err, int err_len) {
+    char text[RCFG_FILE_MAX], out[RCFG_FILE_MAX], tmp_path[PATH_MAX + 8];
+    long long changed_ns = rcfg_now_ns();
+    runtime_config_t candidate;
+    int found = 0, pos = 0;
+
+    pthread_mutex_lock(&publish_mutex);
+    if (read_file(config_path, text, sizeof(text), NULL) < 0) text[0] = '\0';
+
+    // 같은 키의 줄을 바꾸고, 없으면 끝에 추가
+    for (const char* p = text; *p; ) {
+        size_t len = strcspn(p, "\n");
+        const char* k = p + strspn(p, " \t");
+        size_t klen = strlen(key);
+        int match = strncmp(k, key, klen) == 0 && strchr(" \t=", k[klen]) != NULL;
+        if (match && !found) {
+            pos += snprintf(out + pos, sizeof(out) - pos, "%s = %s\n", key, value);
+            found = 1;
+        } else {
+            pos += snprintf(out + pos, sizeof(out) - pos, "%.*s\n", (int)len, p);
+        }
+        p += len;
+        if (*p == '\n') p++;
+        if (pos >= (int)sizeof(out)) break;
+    }
+    if (!found && pos < (int)sizeof(out)) {
+        pos += snprintf(out + pos, sizeof(out) - pos, "%s = %s\n", key, value);
+    }
+    if (pos >= (int)sizeof(out)) {
+        pthread_mutex_unlock(&publish_mutex);
+        snprintf(err, err_len, "config file too large");
+        return -1;
+    }
+
+    // 저장 전에 전체 검증 -> 틀린 값은 파일에도 남기지 않음
+    if (parse_config(out, &candidate, err, err_len) != 0) {
+        pthread_mutex_unlock(&publish_mutex);
+        return -1;
+    }
+
+    // 임시 파일 작성 -> fsync -> rename 으로 원자적 교체 (Python Detector 도 같은 파일을 읽음)
+    // 디스크에 남지 않은 값은 OK 로 알리거나 적용하지 않음 (전원이 나가면 반쪽 파일이 될 수 있으므로)
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", config_path);
+    FILE* fp = fopen(tmp_path, "w");
+    int write_ok = fp != NULL && fputs(out, fp) >= 0 && fflush(fp) == 0 && fsync(fileno(fp)) == 0;
+    if (fp != NULL && fclose(fp) != 0) write_ok = 0;
+    if (!write_ok) {
+        snprintf(err, err_len, "cannot write %s: %s", tmp_path, strerror(errno));
+        unlink(tmp_path);
+        pthread_mutex_unlock(&publish_mutex);
+        return -1;
+    }
+    if (rename(tmp_path, config_path) != 0) {
+        snprintf(err, err_len, "cannot replace %s: %s", config_path, strerror(errno));
+        unlink(tmp_path);
+        pthread_mutex_unlock(&publish_mutex);
+        return -1;
+    }
+    fsync_parent_dir(config_path); // 이름 교체까지 디스크에 (실패해도 파일 내용은 이미 안전)
+
+    struct stat st;
+    if (stat(config_path, &st) == 0) loaded_mtime = st.st_mtim; // 감시 쓰레드가 다시 읽지 않도록
+    publish_locked(&candidate, reason, changed_ns);
+    pthread_mutex_unlock(&publish_mutex);
+    return 0;
+}
+
+// 관리자 명령 (BT/TCP 공용): "RELOAD" 또는 "SET key value"
+// 설정 명령이면 reply 에 "OK vN" / "ERR ..." 을 채우고 1 반환
+int rcfg_admin_command(const char* cmd, const char* reason, char* reply, int reply_len) {
+    char err[160];
+
+    if (strcasecmp(cmd, "RELOAD") == 0) {
+        if (rcfg_reload(reason, rcfg_now_ns()) == 0) {
+            snprintf(reply, reply_len, "OK v%u", rcfg_version());
+        } else {
+            snprintf(reply, reply_len, "ERR reload rejected, keeping v%u", rcfg_version());
+        }
+        return 1;
+    }
+    if (strncasecmp(cmd, "SET ", 4) == 0) {
+        char key[64];
+        const char* p = cmd + 4 + strspn(cmd + 4, " ");
+        int klen = strcspn(p, " =");
+        if (klen == 0 || klen >= (int)sizeof(key)) {
+            snprintf(reply, reply_len, "ERR usage: SET key value");
+            return 1;
+        }
+        memcpy(key, p, klen);
+        key[klen] = '\0';
+        const char* value = p + klen + strspn(p + klen, " =");
+        if (rcfg_set(key, value, reason, err, sizeof(err)) == 0) {
+            snprintf(reply, reply_len, "OK v%u", rcfg_version());
+        } else {
+            snprintf(reply, reply_len, "ERR %s", err);
+        }
+        return 1;
+    }
+    return 0;
+}
+
+void rcfg_note_applied(const runtime_config_t* cfg) {
+    if (cfg->version == applied_version) return; // 대부분 여기서 끝 (비교 1번)
+    applied_version = cfg->version;
+
+    long long now = rcfg_now_ns();
+    LOG4(LOG_CONFIG_APPLIED, cfg->version, cfg->reason,
+         (now - cfg->published_ns) / 1e6, (now - cfg->changed_ns) / 1e6);
+}
+
+// 파일 수정 시각(CLOCK_REALTIME) -> CLOCK_MONOTONIC 기준 시각
+static long long mtime_to_mono_ns(struct timespec mtime) {
+    struct timespec real;
+    clock_gettime(CLOCK_REALTIME, &real);
+    long long age = ((long long)real.tv_sec - mtime.tv_sec) * 1000000000LL + (real.tv_nsec - mtime.tv_nsec);
+    return rcfg_now_ns() - (age > 0 ? age : 0);
+}
+
+static int file_changed(struct timespec* mtime) {
+    struct stat st;
+    if (stat(config_path, &st) != 0) return 0;
+    *mtime = st.st_mtim;
+    pthread_mutex_lock(&publish_mutex);
+    int changed = st.st_mtim.tv_sec != loaded_mtime.tv_sec || st.st_mtim.tv_nsec != loaded_mtime.tv_nsec;
+    pthread_mutex_unlock(&publish_mutex);
+    return changed;
+}
+
+// [쓰레드] 설정 파일 변경 감시
+// 편집기는 보통 새 파일을 쓰고 rename 하므로 파일이 아니라 폴더를 감시
+void* configWatchThreadFunc(void* arg) {
+    char dir[PATH_MAX], buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    const char* slash = strrchr(config_path, '/');
+    if (slash) {
+        snprintf(dir, sizeof(dir), "%.*s", (int)(slash - config_path), config_path);
+    } else {
+        snprintf(dir, sizeof(dir), ".");
+    }
+
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd >= 0 && inotify_add_watch(fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0) {
+        close(fd);
+        fd = -1;
+    }
+    if (fd < 0) {
+        printf(">>> [Config] inotify unavailable, polling %s every second\n", config_path);
+    }
+    struct pollfd pfd = { .fd = fd, .events = POLLIN };
+
+    while (1) {
+        // 폴더 안의 다른 파일 이벤트로 깨어나도 수정 시각이 같으면 다시 읽지 않음
+        // (inotify 가 없거나 이벤트를 놓쳐도 1초마다 수정 시각 확인)
+        if (fd >= 0) {
+            if (poll(&pfd, 1, 1000) > 0) {
+                while (read(fd, buf, sizeof(buf)) > 0) {
+                }
+            }
+        } else {
+            sleep(1);
+        }
+
+        struct timespec mtime;
+        if (file_changed(&mtime)) {
+            rcfg_reload("file", mtime_to_mono_ns(mtime));
+        }
+    }
+    return NULL;
+}
@@ -0,0 +1,45 @@
+#ifndef RUNTIME_CONFIG_H
+#define RUNTIME_CONFIG_H
+
+#include "governor.h"
+
+// 실행 중 변경 가능한 설정 (Runtime Config)
+// - 시작 시 RUNTIME_CONFIG_PATH 파일을 읽고, 파일이 바뀌거나 관리자 명령(BT/TCP)이 오면 다시 읽음
+// - 새 값은 통째로 검증한 뒤 새 스냅샷으로 만들어 포인터 하나만 원자적으로 교체
+//   -> 읽는 쪽(메인 루프 등)은 락 없이 rcfg_acquire() 로 항상 일관된 스냅샷을 봄
+// - 스냅샷 슬롯은 돌려 가며 재사용하지만, rcfg_acquire() ~ rcfg_release() 사이에는 덮어쓰지 않음
+//   (쓰는 쪽이 빈 슬롯이 생길 때까지 기다림) -> 잡는 시간은 짧게 (메인 루프 한 바퀴 이내)
+// - 값 하나만 필요하면 rcfg_version() / rcfg_pir_hold_ms() / rcfg_rate()
+// - config.h 의 매크로는 기본값 (파일에 없는 항목은 기본값 사용)
+
+#define RCFG_PASSWORD_LEN 16
+
+typedef struct {
+    unsigned int version;           // 1: 기본값, 이후 교체할 때마다 증가
+    double dist_danger;             // DANGER 판단 거리 (cm)
+    int pir_hold_ms;                // PIR 감지 유지 시간
+    int rate[RATE_LEVELS][GOV_ROLES]; // 수준별 주기 (ms, DETECTOR_FPS 만 fps)
+    char auth_password[RCFG_PASSWORD_LEN];
+    char admin_password[RCFG_PASSWORD_LEN];
+
+    char reason[8];                 // 교체 원인 ("boot", "file", "bt", "tcp")
+    long long changed_ns;           // 변경 시각 (파일 수정 / 명령 수신, CLOCK_MONOTONIC)
+    long long published_ns;         // 스냅샷 교체 시각
+} runtime_config_t;
+
+int  rcfg_init(const char* path);   // 시작 시 1회 (다른 쓰레드 생성 전)
+const runtime_config_t* rcfg_acquire();        // 현재 스냅샷을 잡음 (락 없음, rcfg_release 까지 바뀌지 않음)
+void rcfg_release(const runtime_config_t* cfg);
+unsigned int rcfg_version();                   // 값 하나만 읽기 (잡고 -> 읽고 -> 놓음)
+int  rcfg_pir_hold_ms();
+int  rcfg_rate(int level, int role);
+int  rcfg_reload(const char* reason, long long changed_ns); // 파일 다시 읽기 (0: 교체, -1: 거부)
+int  rcfg_set(const char* key, const char* value, const char* reason, char* err, int err_len); // 한 항목 변경 + 파일 저장
+void rcfg_note_applied(const runtime_config_t* cfg); // 메인 루프가 새 스냅샷을 처음 쓸 때 반영 시간 기록
+int  rcfg_admin_command(const char* cmd, const char* reason, char* reply, int reply_len); // "RELOAD" / "SET key value" (0: 설정 명령 아님)
+void rcfg_on_change(void (*hook)()); // 교체 직후 호출할 함수 (쓰는 쪽 쓰레드에서 실행)
+long long rcfg_now_ns();
+
+void* configWatchThreadFunc(void* arg); // 파일 변경 감시 (inotify)
+
+#endif // RUNTIME_CONFIG_H
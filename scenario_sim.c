@@ -0,0 +1,399 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "config.h"
+#include "clock.h"
+#include "boot.h"
+#include "sensors.h"
+#include "actuators.h"
+#include "governor.h"
+#include "runtime_config.h"
+#include "ranging.h"
+#include "network.h"
+#include "sentry_loop.h"
+#include "sim_wiring.h"
+
+// =========================================================
+// 시나리오 시뮬레이션 (가상 시계, 하드웨어 없이 실행)
+// =========================================================
+// 사용법: ./scenario_sim [-H 가상 시간(시간)] [-e 침입 간격(분)] [-r (실제 시계로 실행, 비교용)]
+//
+// 실제 모듈(check_pir 의 유지 시간, 초음파 스케줄러, 부저/디스플레이 쓰레드, Rate Governor)과
+// main.c 의 판단 코드(sentry_loop_step)를 그대로 돌리고, wiringPi 대신 sim_wiring 의 핀 / HC-SR04 모델을 사용합니다.
+// 침입 1회 (간격마다 반복):
+//   +0s  PIR 상승 (2초 유지), 카메라에 대상 등장, 거리 300cm 에서 20초 동안 30cm 까지 접근 (카메라 움직임)
+//   +20s 대상이 멈춰 섬 (카메라 존재만 유지, 움직임 없음)
+//   +40s 대상이 사라짐 (카메라 off, 초음파 에코 없음)
+// 확인 항목 (하나라도 벗어나면 FAIL 줄을 출력하고 종료 코드 1):
+//   - 사건마다 WARN -> DANGER 한 번씩, 경보 2회, 사진 1장 이상
+//   - DANGER 진입 시 실제 거리 < dist_danger (지난 사건의 거리로 바로 DANGER 가 되지 않음)
+//   - PIR 유지: 마지막 PIR 하강 후 check_pir() 가 0 이 되기까지 (pir_hold_ms - 메인 루프 주기 ~ pir_hold_ms)
+//   - 움직임 유지: 멈춰 선 대상이 마지막 카메라 움직임 후 WARN/DANGER 를 유지하는 시간 (pir_hold_ms ~ + 메인 루프 주기)
+//   - 부저: WARN 삑 간격 (1000ms), DANGER 사이렌 한 번 (500ms)
+//   - 메인 루프 주기: 감지 주기 수준별 표의 값 이하 (PIR 에지로 일찍 깨어나면 더 짧음)
+//   실제 시계(-r)에서는 쓰레드 스케줄링 지연만큼 여유(REAL_TOLERANCE_MS)를 둠
+// 같은 인자로 다시 실행하면 사건 기록 해시(trace)가 같아야 함 (결정적)
+// 빌드는 -DSIM_BUILD (촬영 요청 / 프레임 속도 파일이 실제 시스템과 다른 경로)
+
+#define EVENT_PIR_PULSE_MS   2000
+#define EVENT_APPROACH_MS    20000
+#define EVENT_LEAVE_MS       40000
+#define EVENT_FAR_CM         300.0
+#define EVENT_NEAR_CM        30.0
+#define DIST_STEP_MS         500   // 대상 위치 갱신 간격
+#define REAL_TOLERANCE_MS    50    // -r: 시간 확인 항목의 허용 오차
+
+// main.c 의 전역 변수 (시뮬레이션에서 정의)
+volatile int current_mode = MODE_SAFE;
+volatile int opencv_motion_detected = 0;
+volatile unsigned int camera_zone_mask = 0;
+pthread_mutex_t mode_mutex;
+
+static const transducer_cfg_t transducers[] = RANGING_TRANSDUCERS; // sensors.c 와 같은 배치
+static volatile double sim_dist = -1; // 시나리오가 정한 실제 거리 (-1: 없음)
+static unsigned long events = 0;      // 시작한 침입 수
+static volatile long long pir_fell_ms = -1; // 마지막으로 PIR 핀이 내려간 시각 (유지 시간 측정용)
+static volatile long long last_motion_ms = -1; // 마지막 카메라 움직임 시각 (움직임 유지 측정용)
+static long long sim_t0_ms;
+
+void send_health_alert(const char* name, int stalled, long duration_ms) {
+}
+
+// 실제 경과 시간 (가상 시계와 비교용)
+static double wall_ms() {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1000.0 + t.tv_nsec / 1e6;
+}
+
+// --- 통계 ---
+
+typedef struct {
+    unsigned long count;
+    double sum, min, max;
+} stat_t;
+
+static void stat_add(stat_t* s, double v) {
+    if (s->count == 0 || v < s->min) s->min = v;
+    if (s->count == 0 || v > s->max) s->max = v;
+    s->sum += v;
+    s->count++;
+}
+
+static void stat_print(const char* name, const stat_t* s, const char* expect) {
+    if (s->count == 0) {
+        printf("%-22s: -\n", name);
+        return;
+    }
+    printf("%-22s: n=%-6lu avg %8.1f  min %8.1f  max %8.1f ms  %s\n",
+           name, s->count, s->sum / s->count, s->min, s->max, expect);
+}
+
+static stat_t pir_latch, motion_hold, warn_beep, danger_sweep, warn_first_tone, danger_first_tone;
+static stat_t loop_period[RATE_LEVELS];
+static unsigned long mode_changes = 0, level_changes = 0;
+static unsigned long mode_entries[MODE_EXIT + 1];
+static double danger_entry_dist = -1; // DANGER 진입 시 실제 거리 중 가장 먼 값
+static unsigned long captures = 0;
+
+// --- 확인 ---
+
+static int failures = 0;
+static double tolerance_ms = 0;
+
+static void check(int ok, const char* what) {
+    if (!ok) {
+        printf("FAIL %s\n", what);
+        failures++;
+    }
+}
+
+// 한 번도 측정되지 않은 항목도 실패 (required 일 때)
+static void check_stat(const char* name, const stat_t* s, double lo, double hi, int required) {
+    char expect[64];
+    snprintf(expect, sizeof(expect), "(expect %.0f .. %.0f)", lo, hi);
+    stat_print(name, s, expect);
+    if (s->count == 0) {
+        check(!required, name);
+        return;
+    }
+    check(s->min >= lo - tolerance_ms && s->max <= hi + tolerance_ms, name);
+}
+
+// 사건 기록 해시 (FNV-1a): 같은 시나리오면 항상 같은 값
+static unsigned int trace_hash = 2166136261u;
+static void trace(long long t_ms, int what, int value) {
+    long long v[3] = { t_ms, what, value };
+    for (int i = 0; i < 3; i++) {
+        for (int b = 0; b < 8; b++) {
+            trace_hash ^= (unsigned char)(v[i] >> (b * 8));
+            trace_hash *= 16777619u;
+        }
+    }
+}
+
+// --- 경보 (network.c 대신) ---
+
+static unsigned long alerts[MODE_EXIT + 1];
+
+void send_alert(int mode) {
+    alerts[mode]++;
+    trace(clock_now_ms(), 6, mode);
+}
+
+// --- 부저 출력 관찰 ---
+
+static long long mode_changed_ms = 0;
+static int mode_at_change = MODE_SAFE;
+static int waiting_first_tone = 0;
+static long long last_warn_beep_ms = -1, last_sweep_ms = -1;
+
+static void on_tone(int pin, int freq) {
+    long long now = clock_now_ms();
+    trace(now, 1, freq);
+
+    // 1000Hz 켜기 = WARN 삑, 500Hz 근처 = DANGER 사이렌 한 번의 시작
+    int is_beep = (freq == 1000 && mode_at_change == MODE_WARN);
+    int is_sweep = (freq == 500);
+    if (waiting_first_tone && (is_beep || is_sweep)) {
+        stat_add(mode_at_change == MODE_WARN ? &warn_first_tone : &danger_first_tone, now - mode_changed_ms);
+        waiting_first_tone = 0;
+    }
+    if (is_beep) {
+        if (last_warn_beep_ms >= 0) stat_add(&warn_beep, now - last_warn_beep_ms);
+        last_warn_beep_ms = now;
+    }
+    if (is_sweep) {
+        if (last_sweep_ms >= 0) stat_add(&danger_sweep, now - last_sweep_ms);
+        last_sweep_ms = now;
+    }
+}
+
+// --- 참가 쓰레드 ---
+
+typedef struct {
+    void* (*fn)(void*);
+    void* arg;
+} participant_t;
+
+static void* participant(void* p) {
+    participant_t* pt = (participant_t*)p;
+    clock_thread_begin();
+    pt->fn(pt->arg);
+    clock_thread_end();
+    return NULL;
+}
+
+static void start_participant(pthread_t* th, participant_t* pt) {
+    clock_thread_add();
+    pthread_create(th, NULL, participant, pt);
+}
+
+// 주변 환경: 침입 시나리오에 맞춰 PIR 핀 / 카메라 / 거리를 바꿈 (정해진 시각에 정확히)
+typedef struct {
+    long long end_ms;
+    long long interval_ms;
+} env_cfg_t;
+
+// 카메라가 대상을 보는 구역(0)의 초음파 센서에 대상까지의 거리를 설정
+static void set_range(double cm) {
+    sim_dist = cm;
+    for (int i = 0; i < (int)(sizeof(transducers) / sizeof(transducers[0])); i++) {
+        if (transducers[i].zone == 0) sim_wiring_set_range(transducers[i].echo_pin, cm);
+    }
+}
+
+static void* environmentThread(void* arg) {
+    env_cfg_t* env = (env_cfg_t*)arg;
+
+    for (long long start = env->interval_ms / 2; start + EVENT_LEAVE_MS < env->end_ms; start += env->interval_ms) {
+        long long wait_ms = sim_t0_ms + start - clock_now_ms();
+        if (wait_ms > 0) clock_sleep_ms(wait_ms);
+
+        // 등장: PIR 상승 (인터럽트 -> 감지 주기 즉시 ACTIVE), 카메라 추적 시작
+        events++;
+        sim_wiring_set(PIR_PIN, 1);
+        pthread_mutex_lock(&mode_mutex);
+        opencv_motion_detected = 1;
+        camera_zone_mask = 1;
+        pthread_mutex_unlock(&mode_mutex);
+        trace(clock_now_ms(), 2, 1);
+
+        for (long long t = 0; t <= EVENT_LEAVE_MS; t += DIST_STEP_MS) {
+            if (t == EVENT_PIR_PULSE_MS) {
+                sim_wiring_set(PIR_PIN, 0);
+                pir_fell_ms = clock_now_ms();
+                trace(clock_now_ms(), 2, 0);
+            }
+            if (t <= EVENT_APPROACH_MS) {
+                camera_note_motion(); // 다가오는 동안은 카메라가 움직임을 봄 (FIFO "V" 줄)
+                last_motion_ms = clock_now_ms();
+            }
+            double k = t >= EVENT_APPROACH_MS ? 1.0 : (double)t / EVENT_APPROACH_MS;
+            set_range(EVENT_FAR_CM + (EVENT_NEAR_CM - EVENT_FAR_CM) * k);
+            clock_sleep_ms(DIST_STEP_MS);
+        }
+
+        // 퇴장
+        pthread_mutex_lock(&mode_mutex);
+        opencv_motion_detected = 0;
+        camera_zone_mask = 0;
+        pthread_mutex_unlock(&mode_mutex);
+        set_range(-1);
+        trace(clock_now_ms(), 3, 0);
+    }
+    return NULL;
+}
+
+// --- 메인 루프 (main.c 와 같은 sentry_loop_step) ---
+
+static void run_main_loop(long long end_ms) {
+    sentry_loop_t loop;
+    sentry_state_t st;
+    long long last_iter_ms = -1;
+    int last_level = governor_level();
+    int mode = MODE_SAFE;
+
+    memset(&st, 0, sizeof(st));
+    sentry_loop_init(&loop);
+
+    while (clock_now_ms() < sim_t0_ms + end_ms) {
+        long long now = clock_now_ms();
+        if (last_iter_ms >= 0) stat_add(&loop_period[last_level], now - last_iter_ms);
+        last_iter_ms = now;
+
+        int new_mode = sentry_loop_step(&loop, &st);
+
+        // PIR 유지 시간: 핀이 내려간 뒤 check_pir() 가 0 이 될 때까지
+        if (!st.pir_detected && pir_fell_ms >= 0) {
+            stat_add(&pir_latch, now - pir_fell_ms);
+            pir_fell_ms = -1;
+        }
+
+        if (new_mode != mode) {
+            // 대상은 아직 보이는데 움직임이 끊겨서 풀린 경우
+            if (new_mode == MODE_SAFE && st.camera_detected && last_motion_ms >= 0) {
+                stat_add(&motion_hold, now - last_motion_ms);
+            }
+            if (new_mode == MODE_DANGER && sim_dist > danger_entry_dist) {
+                danger_entry_dist = sim_dist;
+            }
+            mode_changes++;
+            mode_entries[new_mode]++;
+            trace(now, 4, new_mode);
+            mode_changed_ms = now;
+            mode_at_change = new_mode;
+            waiting_first_tone = (new_mode == MODE_WARN || new_mode == MODE_DANGER);
+            last_warn_beep_ms = last_sweep_ms = -1;
+            mode = new_mode;
+        }
+
+        governor_update(new_mode, st.pir_detected);
+        if (governor_level() != last_level) {
+            level_changes++;
+            trace(now, 5, governor_level());
+        }
+        last_level = governor_level();
+        governor_sleep_ms(governor_period_ms(GOV_MAIN_LOOP));
+    }
+    captures = st.captures;
+}
+
+int main(int argc, char* argv[]) {
+    double hours = 4.0;
+    double interval_min = 10.0;
+    int real = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-H") == 0 && i + 1 < argc) hours = atof(argv[++i]);
+        else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc) interval_min = atof(argv[++i]);
+        else if (strcmp(argv[i], "-r") == 0) real = 1;
+    }
+    if (interval_min * 60000 < EVENT_LEAVE_MS + 5000) {
+        fprintf(stderr, "Intrusion interval must be at least %d s\n", EVENT_LEAVE_MS / 1000 + 5);
+        return 1;
+    }
+
+    // 다른 쓰레드를 만들기 전에 가상 시계로 전환 (0 은 "기록 없음" 으로 쓰는 곳이 있어 1초부터)
+    if (!real) clock_use_virtual(1000000000LL);
+    if (real) tolerance_ms = REAL_TOLERANCE_MS;
+    boot_init();
+    pthread_mutex_init(&mode_mutex, NULL);
+    sim_wiring_on_tone(on_tone);
+    init_governor();
+    for (int i = 0; i < (int)(sizeof(transducers) / sizeof(transducers[0])); i++) {
+        sim_wiring_add_echo(transducers[i].trig_pin, transducers[i].echo_pin);
+    }
+    init_sensors();
+    sim_t0_ms = clock_now_ms();
+
+    env_cfg_t env = { (long long)(hours * 3600000), (long long)(interval_min * 60000) };
+    participant_t p_env = { environmentThread, &env };
+    participant_t p_buzz = { buzzerThreadFunc, NULL };
+    participant_t p_disp = { displayThreadFunc, NULL };
+    participant_t p_rng = { rangingThreadFunc, NULL };
+    pthread_t th_env, th_buzz, th_disp, th_rng;
+
+    clock_t cpu_start = clock();
+    double wall_start = wall_ms();
+
+    start_participant(&th_env, &p_env);
+    start_participant(&th_buzz, &p_buzz);
+    start_participant(&th_disp, &p_disp);
+    start_participant(&th_rng, &p_rng);
+
+    run_main_loop(env.end_ms);
+
+    // 종료: 이 쓰레드는 join 동안 참가에서 빠져야 나머지가 끝까지 돌 수 있음
+    pthread_mutex_lock(&mode_mutex);
+    current_mode = MODE_EXIT;
+    pthread_mutex_unlock(&mode_mutex);
+    clock_thread_end();
+    pthread_join(th_env, NULL);
+    pthread_join(th_buzz, NULL);
+    pthread_join(th_disp, NULL);
+    pthread_join(th_rng, NULL);
+    unlink(TRIGGER_PATH);
+    unlink(RATE_FILE_PATH);
+
+    double cpu_ms = (clock() - cpu_start) * 1000.0 / CLOCKS_PER_SEC;
+    double wall = wall_ms() - wall_start;
+
+    const runtime_config_t* cfg = rcfg_acquire(); // 끝까지 잡음 (다른 쓰는 쪽 없음)
+    int active_period = cfg->rate[RATE_ACTIVE][GOV_MAIN_LOOP];
+    printf("\n--- %.2f h simulated (%s clock) in %.1f ms wall, %.1f ms CPU, %lu time jumps ---\n",
+           hours, real ? "real" : "virtual", wall, cpu_ms, clock_virtual_jumps());
+    printf("intrusions            : %lu, WARN %lu, DANGER %lu, alerts %lu/%lu, captures %lu\n",
+           events, mode_entries[MODE_WARN], mode_entries[MODE_DANGER],
+           alerts[MODE_WARN], alerts[MODE_DANGER], captures);
+    printf("mode changes          : %lu, rate level changes %lu\n", mode_changes, level_changes);
+    printf("DANGER entry distance : %.1f cm (farthest, expect < %.1f)\n", danger_entry_dist, cfg->dist_danger);
+    check(events > 0, "no intrusion in the simulated time");
+    check(mode_entries[MODE_WARN] == events && mode_entries[MODE_DANGER] == events, "WARN -> DANGER once per intrusion");
+    check(alerts[MODE_WARN] == events && alerts[MODE_DANGER] == events, "one WARN and one DANGER alert per intrusion");
+    check(captures >= events, "at least one capture per intrusion");
+    check(danger_entry_dist < cfg->dist_danger, "DANGER entered at a fresh distance below dist_danger");
+    // 유지 시간은 마지막으로 HIGH 를 읽은 루프부터 세므로 핀 하강 시각 기준으로는 최대 한 주기 짧음
+    check_stat("PIR latch", &pir_latch, cfg->pir_hold_ms - active_period, cfg->pir_hold_ms, 1);
+    check_stat("motion hold", &motion_hold, cfg->pir_hold_ms, cfg->pir_hold_ms + active_period, 1);
+    check_stat("WARN beep interval", &warn_beep, 1000, 1000, 1);
+    check_stat("DANGER sweep", &danger_sweep, 500, 500, 1);
+    stat_print("WARN first tone", &warn_first_tone, "(after mode change)");
+    stat_print("DANGER first tone", &danger_first_tone, "(after mode change, WARN beep finishes first)");
+    const char* level_names[RATE_LEVELS] = { "loop period IDLE", "loop period NORMAL", "loop period ACTIVE" };
+    for (int lv = 0; lv < RATE_LEVELS; lv++) {
+        // 시뮬레이션 시간이 짧으면 거치지 않는 수준도 있음
+        check_stat(level_names[lv], &loop_period[lv], 0, cfg->rate[lv][GOV_MAIN_LOOP], 0);
+    }
+    printf("trace hash            : %08x\n", trace_hash);
+    if (failures > 0) {
+        printf("FAIL %d check(s)\n", failures);
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}
@@ -8,19 +8,44 @@
 #include <string.h>
 #include <errno.h> 
 #include <pthread.h> 
+#include <signal.h>
+#include <sys/wait.h>
+#include <sys/prctl.h>
+#include <poll.h>
+#include <limits.h>
 
 #include "config.h"
 #include "sensors.h"
+#include "boot.h"
+#include "watchdog.h"
+#include "governor.h"
+#include "runtime_config.h"
+#include "clock.h"
+#include "ranging.h"
+#include "log.h"
 
 // =========================================================
 // 센서 초기화 및 PIR/초음파 함수
 // =========================================================
 
+// PIR 상승 에지 인터럽트 -> 감지 주기를 즉시 최고 속도로
+static void pir_edge_isr() {
+    governor_on_pir_edge();
+}
+
+static const transducer_cfg_t transducers[] = RANGING_TRANSDUCERS;
+static volatile int ranging_active = 0;
+
 void init_sensors() {
     pinMode(PIR_PIN, INPUT);
-    pinMode(TRIG_PIN, OUTPUT);
-    pinMode(ECHO_PIN, INPUT);
     pullUpDnControl(PIR_PIN, PUD_DOWN);
+
+    // 초음파 센서 배열 (Trig/Echo 핀 설정 포함)
+    init_ranging(&wiringpi_pins, transducers, sizeof(transducers) / sizeof(transducers[0]));
+
+    if (wiringPiISR(PIR_PIN, INT_EDGE_RISING, &pir_edge_isr) < 0) {
+        fprintf(stderr, "[Sensors] PIR interrupt setup failed. (Rate ramp-up only by polling)\n");
+    }
 }
 
 int check_pir() {
@@ -28,20 +53,20 @@ int check_pir() {
     return digitalRead(PIR_PIN);
     */
 
-    static unsigned long last_pir_time = 0; // 마지막 감지 시간을 기억하는 변수 (static)
-    const unsigned long PIR_HOLD_TIME = 10000; // 유지 시간: 10초 (원하는 대로 조절 가능)
+    static long long last_pir_time = 0; // 마지막 감지 시간을 기억하는 변수 (static)
+    const unsigned long PIR_HOLD_TIME = rcfg_pir_hold_ms(); // 유지 시간 (설정 파일 pir_hold_ms, 기본 10초)
     
     // 1. 실제 센서값 읽기
     int current_state = digitalRead(PIR_PIN);
 
     // 2. 움직임이 감지되면(HIGH), 타이머 갱신
     if (current_state == 1) {
-        last_pir_time = millis(); // 현재 시간(ms) 저장
+        last_pir_time = clock_now_ms(); // 현재 시간(ms) 저장
         return 1; // 감지됨
     }
 
     // 3. 지금은 LOW지만, 마지막 감지로부터 10초가 안 지났다면?
-    if ((millis() - last_pir_time) < PIR_HOLD_TIME) {
+    if (last_pir_time != 0 && clock_now_ms() - last_pir_time < PIR_HOLD_TIME) {
         // 아직 사람이 있다고 "거짓말"을 함 (유지 상태)
         return 1; 
     }
@@ -50,32 +75,38 @@ int check_pir() {
     return 0;
 }
 
+// 모든 구역 중 가장 가까운 거리 (cm), 유효한 측정이 없으면 -1
+// 실제 발사는 rangingThreadFunc 가 스케줄러를 통해 수행
 double get_distance() {
-    struct timeval start, end;
-    long timeout = 0;
-
-    digitalWrite(TRIG_PIN, LOW);
-    delayMicroseconds(2);
-    digitalWrite(TRIG_PIN, HIGH);
-    delayMicroseconds(10);
-    digitalWrite(TRIG_PIN, LOW);
+    return ranging_nearest();
+}
 
-    while(digitalRead(ECHO_PIN) == LOW) {
-        if(timeout++ > 30000) return -1;
+// 카메라가 대상을 본 구역의 거리만 사용 (다른 구역의 벽/물체 때문에 DANGER 가 되지 않도록)
+// 해당 구역들에 초음파 센서가 하나도 없을 때만 전체 최근접으로 대체
+// (센서는 있는데 에코가 없거나 오래된 값이면 -1: 다른 구역의 벽/사람 거리를 쓰지 않음)
+double get_distance_in_zones(unsigned int zone_mask) {
+    if (zone_mask & ranging_covered_zones()) {
+        return ranging_nearest_in(zone_mask);
     }
-    gettimeofday(&start, NULL);
+    return ranging_nearest();
+}
 
-    timeout = 0;
-    while(digitalRead(ECHO_PIN) == HIGH) {
-        if(timeout++ > 30000) return -1;
-    }
-    gettimeofday(&end, NULL);
+// 카메라 + PIR 이 모두 감지했을 때만 초음파를 발사 (그 외에는 쉼)
+void set_ranging_active(int active) {
+    ranging_active = active;
+}
 
-    long seconds = end.tv_sec - start.tv_sec;
-    long micros = end.tv_usec - start.tv_usec;
-    double elapsed = seconds + micros / 1000000.0;
-    
-    return elapsed * 34000 / 2;
+// [쓰레드] 초음파 스케줄러 구동
+void* rangingThreadFunc(void* arg) {
+    while (current_mode != MODE_EXIT) {
+        watchdog_beat(HB_RANGING);
+        if (!ranging_active) {
+            clock_sleep_ms(20);
+            continue;
+        }
+        ranging_cycle();
+    }
+    return NULL;
 }
 
 // =========================================================
@@ -94,39 +125,130 @@ int check_opencv_motion() {
 // [IPC] OpenCV 결과 읽기 쓰레드 (FIFO/Named Pipe)
 // =========================================================
 
+// Python Detector 프로세스 상태 (감시 쓰레드 / FIFO 리더 공유)
+static volatile pid_t detector_pid = -1;
+static volatile int detector_stopping = 0;
+static volatile int detector_handshake = 0; // 현재 Detector 가 결과를 한 번이라도 보냈는지
+
+// FIFO 파일을 미리 만들어 둡니다.
+// Python Detector 를 띄우기 전에 호출해야 Python 쪽 open() 이 실패하지 않습니다.
+int init_opencv_fifo() {
+    if (mkfifo(FIFO_PATH, 0666) == -1 && errno != EEXIST) {
+        perror("[FIFO] mkfifo failed");
+        return -1;
+    }
+    return 0;
+}
+
+// 카메라가 마지막으로 "움직이는" 대상을 본 시각 (clock_now_ms, 0: 없음, mode_mutex 로 보호)
+// 존재(M)는 멈춰 있어도 유지되지만, 움직임(V)은 실제로 움직인 프레임에만 옴
+static long long camera_motion_ms = 0;
+
+void camera_note_motion() {
+    pthread_mutex_lock(&mode_mutex);
+    camera_motion_ms = clock_now_ms();
+    pthread_mutex_unlock(&mode_mutex);
+}
+
+// 한 번 확인된 침입자(WARN/DANGER)는 PIR 유지 시간이 지나도 카메라 존재만으로 유지하되,
+// PIR 이나 카메라 움직임이 pir_hold_ms 안에 있었을 때만 (움직이지 않는 유령 추적이 경보를 붙잡지 않도록)
+int check_presence_hold(int pir_detected, int mode) {
+    if (pir_detected) return 1;
+    if (mode != MODE_WARN && mode != MODE_DANGER) return 0;
+    pthread_mutex_lock(&mode_mutex);
+    long long last = camera_motion_ms;
+    pthread_mutex_unlock(&mode_mutex);
+    return last != 0 && clock_now_ms() - last < rcfg_pir_hold_ms();
+}
+
+// 카메라 결과 반영: 구역별 마스크 + 전체 존재 여부 (기존 코드 호환)
+static void apply_camera_result(unsigned int zone_mask) {
+    pthread_mutex_lock(&mode_mutex);
+    camera_zone_mask = zone_mask;
+    opencv_motion_detected = (zone_mask != 0);
+    pthread_mutex_unlock(&mode_mutex);
+
+    // 첫 유효 감지 결과 = 카메라 파이프라인 준비 완료
+    detector_handshake = 1; // 이제 SIGUSR1 핸들러가 설치되어 있음
+    boot_mark_detector_ready();
+    watchdog_beat(HB_CAMERA_FEED);
+}
+
 void* opencvPipeReadThread(void* arg) {
-    char buffer[2];
+    char buffer[64];
     int fd;
+    ssize_t n;
+    char in_mask = 0;           // 파싱 중인 줄 종류 ('M' 존재 / 'V' 움직임, 0: 없음)
+    unsigned int mask_value = 0;
     
-    // 1. FIFO(Named Pipe) 파일 생성
-    if (mkfifo(FIFO_PATH, 0666) == -1 && errno != EEXIST) {
-        perror("[FIFO] mkfifo failed");
+    // 1. FIFO(Named Pipe) 파일 생성 (이미 있으면 그대로 사용)
+    if (init_opencv_fifo() == -1) {
         return NULL;
     }
 
-    printf("[FIFO] Waiting for Python Detector to start and open pipe (%s)...\n", FIFO_PATH);
-    
-    // 2. 파이프 열기 (파이썬이 쓸 때까지 대기)
-    fd = open(FIFO_PATH, O_RDONLY); 
+    // 2. 파이프 열기
+    //    O_NONBLOCK 으로 열면 Python 이 아직 없어도 open() 에서 막히지 않음
+    //    (막혀 있으면 Watchdog 이 이 쓰레드를 볼 수 없음)
+    fd = open(FIFO_PATH, O_RDONLY | O_NONBLOCK); 
     if (fd == -1) {
         perror("[FIFO] open failed");
         return NULL;
     }
     
-    printf("[FIFO] Pipe opened. Reading motion status...\n");
+    printf("[FIFO] Pipe opened. Waiting for Python Detector (%s)...\n", FIFO_PATH);
 
-    // 3. 데이터 수신 루프 (0 또는 1을 읽음)
+    struct pollfd pfd = { .fd = fd, .events = POLLIN };
+
+    // 3. 데이터 수신 루프
+    //    - "M<16진수>\n" : 구역별 존재 마스크 (다중 카메라 Detector)
+    //    - "V<16진수>\n" : 이번 프레임에 실제로 움직인 구역 (0 이 아닐 때만 옴)
+    //    - '0' / '1'     : 예전 단일 카메라 형식 (1 = 구역 구분 없이 존재 + 움직임)
     while (current_mode != MODE_EXIT) {
-        if (read(fd, buffer, 1) > 0) { // 데이터 수신 시 전역 변수 업데이트 (동기화 필요)
-            pthread_mutex_lock(&mode_mutex);
-            if (buffer[0] == '1') {
-                opencv_motion_detected = 1;
-            } else if (buffer[0] == '0') {
-                opencv_motion_detected = 0;
+        watchdog_beat(HB_PIPE_READER);
+        if (poll(&pfd, 1, 100) == 0) {
+            continue; // 타임아웃: 데이터 없음
+        }
+
+        n = read(fd, buffer, sizeof(buffer));
+        if (n > 0) { // 데이터 수신 시 전역 변수 업데이트 (동기화 필요)
+            for (ssize_t i = 0; i < n; i++) {
+                char c = buffer[i];
+                if (in_mask) {
+                    if (c == '\n') {
+                        if (in_mask == 'M') {
+                            apply_camera_result(mask_value);
+                        } else if (mask_value != 0) {
+                            camera_note_motion();
+                        }
+                        in_mask = 0;
+                    } else if (c >= '0' && c <= '9') {
+                        mask_value = (mask_value << 4) | (c - '0');
+                    } else if (c >= 'a' && c <= 'f') {
+                        mask_value = (mask_value << 4) | (c - 'a' + 10);
+                    } else {
+                        in_mask = 0; // 형식 오류 -> 이 줄은 버림
+                    }
+                } else if (c == 'M' || c == 'V') {
+                    in_mask = c;
+                    mask_value = 0;
+                } else if (c == '1') {
+                    apply_camera_result(~0u);
+                    camera_note_motion();
+                } else if (c == '0') {
+                    apply_camera_result(0);
+                }
             }
+            continue; // 밀린 데이터가 있으면 쉬지 않고 바로 읽음
+        }
+        if (n == 0) {
+            // 쓰는 쪽(Python)이 종료됨 -> 재시작될 때까지 마지막 값을 유지하지 않음
+            pthread_mutex_lock(&mode_mutex);
+            opencv_motion_detected = 0;
+            camera_zone_mask = 0;
             pthread_mutex_unlock(&mode_mutex);
+            in_mask = 0;
         }
-        usleep(10000); 
+        clock_sleep_ms(10); // 쓰는 쪽이 없으면 poll 이 바로 리턴하므로 잠깐 쉼
     }
     
     close(fd);
@@ -135,43 +257,153 @@ void* opencvPipeReadThread(void* arg) {
 }
 
 // =========================================================
-// Python Detector 백그라운드 실행 함수 (작동 안됨)
+// Python Detector 자동 실행 및 감시 (Supervisor)
 // =========================================================
-//source venv/bin/activate
-//python3 py_detector.py
+// system("... &") 대신 fork/exec 으로 직접 띄워서 PID 를 관리하고,
+// 비정상 종료 시 지수 백오프로 재시작합니다.
 
-// void start_python_detector() {
-//     const char *command = "/home/pi/Projects/github/Embedded_System_5team/Code/Embedded_System/venv/bin/python3 /home/pi/Projects/github/Embedded_System_5team/Code/Embedded_System/py_detector.py > /tmp/py_log.txt 2>&1 &";
-    
-//     printf("[Auto Start] Executing Python Detector: %s\n", command);
+// 실행 파일(sentry_system) 위치 기준 절대 경로 (sudo ./sentry_system 을 어디서 실행해도 같은 파일)
+static char py_python_path[PATH_MAX];
+static char py_script_path[PATH_MAX];
 
-//     int result = system(command);
+static void resolve_exe_relative(const char* rel, char* out, size_t len) {
+    char exe[PATH_MAX];
+    ssize_t n = (rel[0] == '/') ? -1 : readlink("/proc/self/exe", exe, sizeof(exe) - 1);
+    char* slash = NULL;
+    if (n > 0) {
+        exe[n] = '\0';
+        slash = strrchr(exe, '/');
+    }
+    if (slash == NULL) {
+        snprintf(out, len, "%s", rel); // 이미 절대 경로이거나 /proc 을 못 읽음
+        return;
+    }
+    *slash = '\0';
+    snprintf(out, len, "%s/%s", exe, rel);
+}
 
-//     if (result == -1) {
-//         perror("[Auto Start] system() function call failed");
-//     } else {
-//         printf("[Auto Start] Python Detector started.\n");
-//     }
-// }
+static pid_t spawn_python_detector() {
+    pid_t parent = getpid();
+    pid_t pid = fork();
+    if (pid == 0) {
+        // [자식] 부모(sentry)가 죽으면 같이 종료되도록 설정 (카메라 점유 방지)
+        prctl(PR_SET_PDEATHSIG, SIGTERM);
+        // prctl 전에 부모가 이미 죽었으면 신호가 오지 않으므로 직접 확인
+        if (getppid() != parent) _exit(1);
+
+        int log_fd = open(PY_DETECTOR_LOG, O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (log_fd != -1) {
+            dup2(log_fd, STDOUT_FILENO);
+            dup2(log_fd, STDERR_FILENO);
+            close(log_fd);
+        }
+        execl(py_python_path, py_python_path, "-u", py_script_path, (char*)NULL);
+        _exit(127); // exec 실패
+    }
+    return pid;
+}
+
+static void* detectorSupervisorThread(void* arg) {
+    int backoff_ms = PY_RESTART_MIN_MS;
+
+    while (!detector_stopping) {
+        long started_us = boot_elapsed_us();
+        detector_handshake = 0;
+        pid_t pid = spawn_python_detector();
+        if (pid == -1) {
+            perror("[Auto Start] fork failed");
+        } else {
+            detector_pid = pid;
+            printf("[Auto Start] Python Detector started (pid %d, +%.1f ms).\n", pid, started_us / 1000.0);
+
+            int status = 0;
+            pid_t waited;
+            while ((waited = waitpid(pid, &status, 0)) == -1 && errno == EINTR);
+            int wait_errno = errno;
+            detector_pid = -1;
+
+            if (detector_stopping) break;
+            if (waited == -1) {
+                // 종료 상태를 알 수 없음 (ECHILD: 다른 곳에서 이미 회수됨, SIGCHLD 무시 등) -> 재시작만 함
+                if (wait_errno == ECHILD) {
+                    printf("[Auto Start] Python Detector (pid %d) is no longer our child, status unknown.\n", pid);
+                } else {
+                    errno = wait_errno;
+                    perror("[Auto Start] waitpid failed");
+                    kill(pid, SIGTERM); // 아직 살아 있다면 새로 띄우기 전에 정리 (카메라 점유 방지)
+                }
+            } else if (WIFEXITED(status)) {
+                printf("[Auto Start] Python Detector exited (code %d).\n", WEXITSTATUS(status));
+            } else if (WIFSIGNALED(status)) {
+                printf("[Auto Start] Python Detector killed (signal %d).\n", WTERMSIG(status));
+            }
+        }
+
+        // 충분히 오래 돌았으면 백오프 초기화, 아니면 2배씩 증가
+        if ((boot_elapsed_us() - started_us) / 1000 >= PY_STABLE_RUN_MS) {
+            backoff_ms = PY_RESTART_MIN_MS;
+        }
+        printf("[Auto Start] Restarting Python Detector in %d ms...\n", backoff_ms);
+        clock_sleep_ms(backoff_ms);
+        backoff_ms *= 2;
+        if (backoff_ms > PY_RESTART_MAX_MS) backoff_ms = PY_RESTART_MAX_MS;
+    }
+    return NULL;
+}
+
+void start_python_detector() {
+    resolve_exe_relative(PY_DETECTOR_PYTHON, py_python_path, sizeof(py_python_path));
+    resolve_exe_relative(PY_DETECTOR_SCRIPT, py_script_path, sizeof(py_script_path));
+    printf("[Auto Start] Detector: %s %s\n", py_python_path, py_script_path);
+
+    pthread_t th_sup;
+    if (pthread_create(&th_sup, NULL, detectorSupervisorThread, NULL) != 0) {
+        perror("[Auto Start] Supervisor thread create failed");
+        return;
+    }
+    pthread_detach(th_sup);
+}
+
+// 감지 주기 변경 알림 (SIGUSR1 -> Python 이 대기 중이면 바로 다음 프레임 처리)
+// 핸들러 설치 전에 보내면 Python 이 종료되므로, 첫 결과를 받은 뒤에만 보냄
+void notify_python_detector() {
+    pid_t pid = detector_pid;
+    if (pid > 0 && detector_handshake) {
+        kill(pid, SIGUSR1);
+    }
+}
+
+// 시그널 핸들러에서도 호출 가능 (kill 은 async-signal-safe)
+void stop_python_detector() {
+    detector_stopping = 1;
+    pid_t pid = detector_pid;
+    if (pid > 0) {
+        kill(pid, SIGTERM);
+    }
+}
 
 
 // =========================================================
 // 카메라 캡처 함수 (Python 트리거 방식)
 // =========================================================
 
-int capture_image() {
+// incident_id: 같은 침입 사건의 사진을 한 폴더로 묶기 위한 번호 (사건 시작 시각)
+int capture_image(long incident_id) {
     // Python에게 촬영 신호를 보내기 위해 파일을 생성합니다.
-    const char *trigger_cmd = "touch /tmp/trigger_capture";
-
-    printf("[Camera] Requesting capture via Python trigger...\n");
-
-    int result = system(trigger_cmd);
+    // system("touch ...") 은 셸을 fork 하므로 제어 루프에서 직접 씀 (임시 파일 -> rename 으로 원자적 생성)
+    FILE* fp = fopen(TRIGGER_PATH ".tmp", "w");
+    if (fp == NULL) {
+        perror("[Camera] Failed to create trigger file");
+        return -1;
+    }
+    fprintf(fp, "%ld\n", incident_id);
+    fclose(fp);
 
-    if (result == -1) {
+    if (rename(TRIGGER_PATH ".tmp", TRIGGER_PATH) == -1) {
         perror("[Camera] Failed to create trigger file");
         return -1;
-    } 
+    }
     
-    printf("✅ [Camera] Capture request sent.\n");
+    LOG1(LOG_CAPTURE_REQUEST, incident_id);
     return 0;
 }
\ No newline at end of file
@@ -3,14 +3,22 @@
 
 void init_sensors();
 int check_pir();       // 움직임 감지 시 1 반환 (PIR)
-double get_distance(); // 거리(cm) 반환 (초음파)
+double get_distance(); // 거리(cm) 반환 (초음파, 모든 구역 중 최근접)
+double get_distance_in_zones(unsigned int zone_mask); // 카메라가 대상을 본 구역들 중 최근접
+void set_ranging_active(int active); // 초음파 스케줄러 발사 여부
+void* rangingThreadFunc(void* arg);  // 초음파 스케줄러 쓰레드
 int check_opencv_motion(); // OpenCV 움직임 감지 결과 반환 (전역 변수 읽기)
-int capture_image();   // 카메라 캡처 및 성공 시 0 반환
+int capture_image(long incident_id); // 카메라 캡처 요청, 성공 시 0 반환
+void camera_note_motion();  // 카메라가 움직이는 대상을 봄 (FIFO "V" 줄)
+int check_presence_hold(int pir_detected, int mode); // PIR 또는 (WARN/DANGER + pir_hold_ms 안의 카메라 움직임)
 
 // IPC 통신 쓰레드 원형
+int init_opencv_fifo();    // FIFO 파일 생성 (Python 실행 전에 호출)
 void* opencvPipeReadThread(void* arg); 
 
-// Python Detector 자동 실행 함수 원형
+// Python Detector 자동 실행 + 감시 (비정상 종료 시 재시작)
 void start_python_detector(); 
+void stop_python_detector();
+void notify_python_detector(); // 감지 주기 변경 알림 (SIGUSR1)
 
 #endif
\ No newline at end of file
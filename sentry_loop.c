@@ -0,0 +1,159 @@
+#include <stdio.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "config.h"
+#include "sentry_loop.h"
+#include "sensors.h"
+#include "network.h"
+#include "watchdog.h"
+#include "runtime_config.h"
+#include "clock.h"
+#include "log.h"
+
+// =========================================================
+// 메인 루프 판단 (main.c / scenario_sim.c 공용)
+// =========================================================
+
+void sentry_loop_init(sentry_loop_t* lp) {
+    lp->incident_id = 0;
+    lp->safe_dist = 0;
+    lp->last_capture_ms = 0;
+    lp->last_alert_mode = MODE_SAFE;
+    lp->incident_base_s = (long)time(NULL);
+    lp->incident_base_ms = clock_now_ms();
+    lp->last_incident_id = 0;
+}
+
+// 같은 초에 사건이 두 번 시작돼도 겹치지 않도록 항상 이전 번호보다 큼
+static long new_incident_id(sentry_loop_t* lp) {
+    long id = lp->incident_base_s + (long)((clock_now_ms() - lp->incident_base_ms) / 1000);
+    if (id <= lp->last_incident_id) id = lp->last_incident_id + 1;
+    lp->last_incident_id = id;
+    return id;
+}
+
+// 수정된 시나리오: Cam+PIR 필수 -> 이후 거리 측정
+int sentry_loop_step(sentry_loop_t* lp, sentry_state_t* st) {
+    int local_mode;
+    int opencv_detected;
+    unsigned int zone_mask;
+
+    // 이번 바퀴에서 쓸 설정 스냅샷 (락 없음, 새 버전이면 반영 시간 기록, 돌아가기 전에 놓음)
+    const runtime_config_t* cfg = rcfg_acquire();
+    rcfg_note_applied(cfg);
+
+    // [LOCK] OpenCV 감지 결과 읽기
+    pthread_mutex_lock(&mode_mutex);
+    opencv_detected = opencv_motion_detected;
+    zone_mask = camera_zone_mask;
+    pthread_mutex_unlock(&mode_mutex);
+
+    // --- 1. PIR 센서 값 읽기 ---
+    int pir_detected = check_pir();
+
+    // [저하 모드] 카메라 피드가 멈췄으면 PIR 단독으로 판단
+    if (watchdog_is_stalled(HB_CAMERA_FEED)) {
+        opencv_detected = pir_detected;
+        zone_mask = ~0u; // PIR 은 구역 구분이 없음
+    }
+
+    // --- 2. 시나리오 판단 시작 ---
+
+    // [조건 1] 카메라와 PIR이 '둘 다' 감지되었는가? (AND 조건)
+    // 카메라 값은 움직임이 아니라 "추적 중인 대상 존재" 이므로,
+    // 한 번 확인된 침입자(WARN/DANGER)는 PIR 유지 시간이 지나도 카메라 존재로 유지
+    // (단, pir_hold_ms 안에 카메라가 움직임을 봤을 때만 - check_presence_hold)
+    pthread_mutex_lock(&mode_mutex);
+    local_mode = current_mode;
+    pthread_mutex_unlock(&mode_mutex);
+    int pir_or_verified = check_presence_hold(pir_detected, local_mode);
+    int target_verified = (opencv_detected == 1 && pir_or_verified);
+    st->camera_detected = opencv_detected;
+    st->camera_zone_mask = zone_mask;
+    st->pir_detected = pir_detected;
+    st->degraded = watchdog_is_stalled(HB_CAMERA_FEED);
+    st->target_verified = target_verified;
+
+    // 조건을 만족하는 동안에만 초음파 스케줄러가 발사
+    set_ranging_active(target_verified);
+    if (target_verified) {
+        // SAFE 에서 벗어나는 순간부터 다시 SAFE 가 될 때까지를 하나의 사건으로 묶음
+        if (lp->incident_id == 0) {
+            lp->incident_id = new_incident_id(lp);
+        }
+
+        // 1차 조건 만족! 이제야 비로소 거리를 측정합니다.
+        // 카메라가 대상을 본 구역의 거리만 사용 (-1: 스케줄러가 막 켜졌거나 측정이 오래됨 -> 이전 값 유지)
+        double raw_dist = get_distance_in_zones(zone_mask);
+        if (raw_dist != -1) {
+            lp->safe_dist = raw_dist;
+        }
+        double dist = lp->safe_dist;
+        st->dist_used = dist;
+
+        // [조건 2] 거리가 위험 수준인가?
+        if (dist > 0 && dist < cfg->dist_danger) {
+            // -> MODE_DANGER (침입자가 확실하고, 거리도 가까움)
+            pthread_mutex_lock(&mode_mutex);
+            local_mode = current_mode;
+
+            if (local_mode != MODE_DANGER) {
+                LOG1(LOG_MODE_DANGER, dist);
+                if (lp->last_alert_mode != MODE_DANGER) {
+                    send_alert(MODE_DANGER);
+                    lp->last_alert_mode = MODE_DANGER;
+                    st->alerts_sent++;
+                }
+            }
+            current_mode = MODE_DANGER;
+            pthread_mutex_unlock(&mode_mutex);
+
+            // 사진 캡처 (DANGER 진입 즉시 1장, 이후 CAPTURE_INTERVAL_MS 마다 연속 촬영)
+            if (lp->last_capture_ms == 0 || clock_now_ms() - lp->last_capture_ms >= CAPTURE_INTERVAL_MS) {
+                capture_image(lp->incident_id);
+                st->captures++;
+                lp->last_capture_ms = clock_now_ms();
+            }
+        }
+        else {
+            // -> MODE_WARN (침입자는 맞는데, 아직 거리는 멂)
+            pthread_mutex_lock(&mode_mutex);
+            local_mode = current_mode;
+
+            if (local_mode != MODE_WARN) {
+                LOG0(LOG_MODE_WARN);
+                if (lp->last_alert_mode != MODE_WARN) {
+                    send_alert(MODE_WARN);
+                    lp->last_alert_mode = MODE_WARN;
+                    st->alerts_sent++;
+                }
+            }
+            current_mode = MODE_WARN;
+            lp->last_capture_ms = 0; // WARN 상태에서는 캡처 플래그 초기화
+            pthread_mutex_unlock(&mode_mutex);
+        }
+    }
+    // [조건 불만족] 카메라나 PIR 중 하나라도 감지 안 되면 -> SAFE
+    else {
+        pthread_mutex_lock(&mode_mutex);
+        if (current_mode != MODE_SAFE) {
+            LOG2(LOG_MODE_SAFE, opencv_detected, pir_detected);
+            current_mode = MODE_SAFE;
+            lp->last_alert_mode = MODE_SAFE;
+        }
+        lp->incident_id = 0;   // 사건 종료
+        lp->safe_dist = 0;     // 지난 사건의 거리로 다음 사건을 바로 DANGER 로 판단하지 않도록
+        lp->last_capture_ms = 0;
+        pthread_mutex_unlock(&mode_mutex);
+    }
+
+    pthread_mutex_lock(&mode_mutex);
+    local_mode = current_mode;
+    pthread_mutex_unlock(&mode_mutex);
+
+    st->mode = local_mode;
+    st->incident_id = lp->incident_id;
+    rcfg_release(cfg);
+    return local_mode;
+}
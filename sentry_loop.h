@@ -0,0 +1,27 @@
+#ifndef SENTRY_LOOP_H
+#define SENTRY_LOOP_H
+
+#include "sentry_state.h"
+
+// 메인 루프 한 바퀴의 판단 (카메라 + PIR -> WARN, 대상 구역 거리 < dist_danger -> DANGER)
+// - main.c 와 scenario_sim.c 가 같은 코드를 사용 (시뮬레이션이 실제 판단 규칙과 초음파 스케줄러를 그대로 시험)
+// - 센서 읽기 -> 모드 결정 -> 경보(send_alert) / 사진 요청(capture_image) 까지
+//   잠들기(governor) / 상태 기록(state_shm) 은 호출한 쪽에서
+// - 메인 쓰레드 하나에서만 호출
+
+typedef struct {
+    long incident_id;          // 현재 침입 사건 번호 (0: 사건 없음)
+    double safe_dist;          // 이번 사건에서 마지막으로 유효했던 거리 (0: 아직 측정 없음 -> WARN 유지)
+    long long last_capture_ms; // 마지막 캡처 시각 (0: 이번 DANGER 에서 아직 안 찍음)
+    int last_alert_mode;
+
+    // 사건 번호 (증거 폴더 이름에 쓰이므로 벽시계 초 단위, 시작 시 벽시계 + clock_now_ms() 경과)
+    long incident_base_s;
+    long long incident_base_ms;
+    long last_incident_id;
+} sentry_loop_t;
+
+void sentry_loop_init(sentry_loop_t* lp);
+int  sentry_loop_step(sentry_loop_t* lp, sentry_state_t* st); // 이번 바퀴의 모드 반환 (st 의 판단/센서/카운터 갱신)
+
+#endif // SENTRY_LOOP_H
@@ -0,0 +1,187 @@
+#ifndef SENTRY_STATE_H
+#define SENTRY_STATE_H
+
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+// 공유 메모리 상태 미러 (쓰는 쪽: state_shm.c, 읽는 쪽: statedump.c 및 같은 장치의 다른 프로그램)
+// - sentry_system 의 메인 루프가 한 바퀴마다 전체 상태를 SENTRY_STATE_SHM_NAME 에 기록
+// - seqlock: 쓰는 쪽은 seq 를 홀수로 만들고 -> 내용 복사 -> 짝수로 되돌림
+//   읽는 쪽은 seq 가 짝수이고 복사 전후로 같을 때만 사용 (아니면 다시 읽음)
+//   -> 읽는 쪽 수와 관계없이 쓰는 쪽은 절대 기다리지 않고, 읽는 쪽도 시스템 콜 없이 읽음
+// - 변경을 기다리려면 sentry_state_wait() (seq 에 대한 futex)
+//   기다리는 쪽 수는 SENTRY_STATE_WAITERS_SHM_NAME 에 따로 셈 -> 쓰는 쪽은 0 이 아닐 때만 FUTEX_WAKE
+//   (상태는 0644 로 읽기 전용 그대로 두고, 아무 사용자나 쓸 수 있는 것은 이 카운터뿐
+//    -> 잘못 건드려도 불필요한 FUTEX_WAKE 가 생기거나 대기가 timeout 으로 끝날 뿐 상태는 바뀌지 않음)
+// - 이 헤더만 include 하면 되도록 config.h 에 의존하지 않음 (레이아웃이 바뀌면 SENTRY_STATE_LAYOUT 증가)
+//
+// 사용 예:
+//   const sentry_state_shm_t* shm = sentry_state_open();
+//   sentry_state_t s;
+//   if (shm && sentry_state_read(shm, &s, NULL) == 0) printf("mode %d\n", s.mode);
+
+#define SENTRY_STATE_SHM_NAME "/sentry_state"
+#define SENTRY_STATE_WAITERS_SHM_NAME "/sentry_state_waiters" // uint32_t 하나 (0666)
+#define SENTRY_STATE_MAGIC    0x53535431u // "SST1"
+#define SENTRY_STATE_LAYOUT   2
+#define SENTRY_STATE_ZONES    4           // config.h 의 MAX_ZONES 와 같아야 함
+
+// 메인 쓰레드 하트비트 번호 (watchdog.h 의 HB_* 순서와 같음, stalled_mask 의 비트)
+#define SENTRY_STATE_HB_NAMES { "main", "display", "buzzer", "pipe", "camera", "bt", "wifi", "ranging" }
+
+typedef struct {
+    double   dist;         // 구역 내 최근접 거리 (cm, -1: 유효한 측정 없음)
+    int64_t  measured_ns;  // 측정 시각 (CLOCK_MONOTONIC, 0: 아직 없음)
+    uint32_t seq;          // 구역 값이 갱신될 때마다 증가
+    uint32_t reserved;
+} sentry_zone_state_t;
+
+typedef struct {
+    // 기록 정보
+    int64_t  update_ns;        // 마지막 기록 시각 (CLOCK_MONOTONIC, 읽는 쪽의 시계와 같은 기준)
+    int64_t  update_real_ms;   // 마지막 기록 시각 (CLOCK_REALTIME, ms)
+    int64_t  started_real_ms;  // sentry_system 시작 시각
+    int32_t  pid;              // sentry_system pid (살아 있는지는 sentry_state_pid_alive() 로 확인)
+    uint32_t config_version;   // 실행 중 설정 버전 (runtime_config.c)
+
+    // 판단 상태
+    int32_t  mode;             // MODE_SAFE / MODE_WARN / MODE_DANGER (config.h)
+    int32_t  rate_level;       // 감지 주기 수준 (0: IDLE, 1: NORMAL, 2: ACTIVE)
+    int32_t  target_verified;  // 카메라 + PIR 로 침입자 확인 (초음파 측정 중)
+    int32_t  degraded;         // 카메라 피드가 멈춰 PIR 단독 판단 중
+    double   dist_used;        // 마지막으로 판단에 쓴 거리 (cm, 0: 아직 없음)
+    int64_t  incident_id;      // 현재 사건 번호 (0: 사건 없음)
+    int64_t  mode_since_ns;    // 현재 모드에 들어온 시각 (CLOCK_MONOTONIC)
+
+    // 센서
+    int32_t  camera_detected;  // 추적 중인 대상 존재 (모든 카메라 합산)
+    uint32_t camera_zone_mask; // 대상이 보이는 구역 (bit n: 구역 n)
+    int32_t  pir_detected;     // PIR (유지 시간 포함)
+    uint32_t stalled_mask;     // 멈춘 하트비트 (bit n: SENTRY_STATE_HB_NAMES[n])
+    sentry_zone_state_t zones[SENTRY_STATE_ZONES]; // 초음파 구역별 값
+
+    // 잠금 / 인증
+    int32_t  motor_locked;
+    int32_t  auth_user_count;  // 일반 인증 사용자 (HC-06 은 0 또는 1)
+    int32_t  admin_override;   // 관리자 강제 열림
+    int32_t  reserved;
+
+    // 누적 카운터 (시작 후)
+    uint64_t loops;            // 메인 루프 횟수
+    uint64_t mode_changes;
+    uint64_t alerts_sent;      // WARN/DANGER 경보 전송
+    uint64_t captures;         // 증거 사진 요청
+    uint64_t ranging_accepted; // 확정된 초음파 측정
+    uint64_t ranging_timeouts;
+    uint64_t ranging_crosstalk;
+} sentry_state_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t layout;
+    uint32_t size;             // sizeof(sentry_state_shm_t)
+    uint32_t seq;              // seqlock 번호 (홀수: 기록 중), futex 주소로도 사용
+    sentry_state_t state;
+} sentry_state_shm_t;
+
+// 읽는 쪽 매핑: [대기 수 카운터 1페이지 (읽기/쓰기)][상태 (읽기 전용)] 을 이어 붙여서
+// sentry_state_wait() 가 shm 포인터만으로 카운터를 찾도록 함
+static inline uint32_t* sentry_state_waiters(const sentry_state_shm_t* shm) {
+    return (uint32_t*)((char*)shm - sysconf(_SC_PAGESIZE));
+}
+
+// 읽기 전용으로 연결 (sentry_system 이 아직 만들지 않았거나 레이아웃이 다르면 NULL)
+static inline const sentry_state_shm_t* sentry_state_open() {
+    long page = sysconf(_SC_PAGESIZE);
+    size_t total = page + sizeof(sentry_state_shm_t);
+    int fd = shm_open(SENTRY_STATE_SHM_NAME, O_RDONLY, 0);
+    if (fd < 0) return NULL;
+    int wfd = shm_open(SENTRY_STATE_WAITERS_SHM_NAME, O_RDWR, 0);
+    if (wfd < 0) {
+        close(fd);
+        return NULL;
+    }
+
+    // 자리를 먼저 잡고 두 객체를 그 안에 MAP_FIXED 로 붙임
+    char* base = (char*)mmap(NULL, total, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    int ok = base != MAP_FAILED &&
+             mmap(base, page, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, wfd, 0) != MAP_FAILED &&
+             mmap(base + page, sizeof(sentry_state_shm_t), PROT_READ, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED;
+    close(fd);
+    close(wfd);
+    if (!ok) {
+        if (base != MAP_FAILED) munmap(base, total);
+        return NULL;
+    }
+
+    const sentry_state_shm_t* shm = (const sentry_state_shm_t*)(base + page);
+    if (shm->magic != SENTRY_STATE_MAGIC || shm->layout != SENTRY_STATE_LAYOUT ||
+        shm->size != sizeof(sentry_state_shm_t)) {
+        munmap(base, total);
+        return NULL;
+    }
+    return shm;
+}
+
+// pid 가 살아 있는지 (sudo 로 실행된 sentry_system 에는 kill 권한이 없어 EPERM 이 오지만 살아 있는 것)
+static inline int sentry_state_pid_alive(int32_t pid) {
+    return pid > 0 && (kill(pid, 0) == 0 || errno == EPERM);
+}
+
+// seqlock 으로 사본 1개 기록 (쓰는 쪽 1개만 호출, state_shm.c 와 statedump -t 검사가 같이 사용)
+// 기다리는 읽는 쪽을 깨우는 FUTEX_WAKE 는 호출한 쪽에서
+static inline void sentry_state_write(sentry_state_shm_t* shm, const sentry_state_t* s) {
+    uint32_t seq = __atomic_load_n(&shm->seq, __ATOMIC_RELAXED);
+    __atomic_store_n(&shm->seq, seq + 1, __ATOMIC_RELAXED); // 홀수: 기록 중
+    __atomic_thread_fence(__ATOMIC_RELEASE);                 // 내용 기록이 홀수 표시보다 앞서 보이지 않도록
+    memcpy(&shm->state, s, sizeof(*s));
+    __atomic_store_n(&shm->seq, seq + 2, __ATOMIC_RELEASE);  // 짝수: 완료
+}
+
+// 일관된 사본 1개 읽기 (0: 성공, -1: 계속 기록 중이라 max 회 안에 못 읽음)
+// seq_out: 읽은 사본의 번호 (sentry_state_wait 에 넘겨 다음 변경을 기다릴 때 사용)
+static inline int sentry_state_read(const sentry_state_shm_t* shm, sentry_state_t* out, uint32_t* seq_out) {
+    for (int tries = 0; tries < 1000; tries++) {
+        uint32_t s1 = __atomic_load_n(&shm->seq, __ATOMIC_ACQUIRE);
+        if (s1 & 1) continue; // 기록 중
+        memcpy(out, (const void*)&shm->state, sizeof(*out));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&shm->seq, __ATOMIC_RELAXED) == s1) {
+            if (seq_out) *seq_out = s1;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+// seq 가 last_seq 에서 바뀔 때까지 대기 (0: 바뀜, -1: 시간 초과, timeout_ms < 0: 무한 대기)
+// sentry_state_open() 으로 연결한 shm 만 사용 가능 (대기 수 카운터가 앞 페이지에 있어야 함)
+static inline int sentry_state_wait(const sentry_state_shm_t* shm, uint32_t last_seq, int timeout_ms) {
+    struct timespec ts = { timeout_ms / 1000, (timeout_ms % 1000) * 1000000L };
+    uint32_t* waiters = sentry_state_waiters(shm);
+    int result = 0;
+
+    // 카운터 증가 -> seq 확인 순서 (쓰는 쪽은 seq 기록 -> 카운터 확인): 둘 중 하나는 반드시 상대를 봄
+    __atomic_fetch_add(waiters, 1, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(&shm->seq, __ATOMIC_SEQ_CST) == last_seq) {
+        // 공유(프로세스 간) futex 이므로 FUTEX_PRIVATE_FLAG 를 쓰지 않음
+        long r = syscall(SYS_futex, &shm->seq, FUTEX_WAIT, last_seq, timeout_ms < 0 ? NULL : &ts, NULL, 0);
+        if (r < 0 && errno == ETIMEDOUT) {
+            result = -1;
+            break;
+        }
+    }
+    __atomic_fetch_sub(waiters, 1, __ATOMIC_SEQ_CST);
+    return result;
+}
+
+#endif // SENTRY_STATE_H
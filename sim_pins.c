@@ -0,0 +1,108 @@
+#include "config.h"
+#include "sim_pins.h"
+
+#define SIM_BURST_US     200   // 트리거 후 40kHz 버스트 송신 시간 (에코 핀 상승까지)
+#define SIM_NO_ECHO_US   38000 // 물체가 없을 때 HC-SR04 가 에코 핀을 유지하는 시간
+#define SIM_READ_COST_US 1     // 핀 읽기 1회에 걸리는 가상 시간
+#define SIM_EMIT_HISTORY 4     // 크로스토크 계산에 쓰는 최근 발사 기록 수
+
+typedef struct {
+    int trig_pin, echo_pin;
+    int trig_level;
+    long trig_high_us;
+    long echo_rise, echo_fall;        // 현재 에코 구간 (-1: 없음)
+    long emits[SIM_EMIT_HISTORY];     // 최근 발사 시각
+    int emit_pos;
+    double target_cm;
+} sim_transducer_t;
+
+static sim_transducer_t st[MAX_TRANSDUCERS];
+static int st_count = 0;
+static long xtalk_delay[MAX_TRANSDUCERS][MAX_TRANSDUCERS];
+static long vt = 1; // 가상 시간 (0 은 "기록 없음" 으로 쓰이므로 1부터)
+
+void sim_pins_init(const transducer_cfg_t* cfg, int count) {
+    st_count = count;
+    for (int i = 0; i < count; i++) {
+        st[i].trig_pin = cfg[i].trig_pin;
+        st[i].echo_pin = cfg[i].echo_pin;
+        st[i].trig_level = 0;
+        st[i].echo_rise = st[i].echo_fall = -1;
+        for (int e = 0; e < SIM_EMIT_HISTORY; e++) st[i].emits[e] = -1;
+        st[i].emit_pos = 0;
+        st[i].target_cm = -1;
+        for (int j = 0; j < count; j++) xtalk_delay[i][j] = 0;
+    }
+}
+
+void sim_set_target(int idx, double cm) {
+    st[idx].target_cm = cm;
+}
+
+void sim_set_crosstalk(int from, int to, long delay_us) {
+    xtalk_delay[from][to] = delay_us;
+}
+
+long sim_now_us() {
+    return vt;
+}
+
+static int find_pin(int pin, int want_echo) {
+    for (int i = 0; i < st_count; i++) {
+        if ((want_echo ? st[i].echo_pin : st[i].trig_pin) == pin) return i;
+    }
+    return -1;
+}
+
+static void sim_mode(int pin, int is_output) {
+}
+
+static void sim_write(int pin, int value) {
+    int i = find_pin(pin, 0);
+    if (i < 0) return;
+    sim_transducer_t* t = &st[i];
+
+    if (value == 1 && t->trig_level == 0) {
+        t->trig_high_us = vt;
+    }
+    // 10us 이상 HIGH 였다가 떨어지면 발사
+    else if (value == 0 && t->trig_level == 1 && vt - t->trig_high_us >= 10) {
+        long emit = vt + SIM_BURST_US;
+        t->echo_rise = emit;
+        t->echo_fall = (t->target_cm >= 0) ? emit + (long)(t->target_cm / 0.017) : emit + SIM_NO_ECHO_US;
+        t->emits[t->emit_pos] = emit;
+        t->emit_pos = (t->emit_pos + 1) % SIM_EMIT_HISTORY;
+    }
+    t->trig_level = value;
+}
+
+static int sim_read(int pin) {
+    vt += SIM_READ_COST_US;
+
+    int j = find_pin(pin, 1);
+    if (j < 0 || st[j].echo_rise < 0) return 0;
+
+    // 다른 센서의 발사음이 에코 구간 안에 먼저 도착하면 에코가 일찍 끝남 (크로스토크)
+    long fall = st[j].echo_fall;
+    for (int i = 0; i < st_count; i++) {
+        if (i == j || xtalk_delay[i][j] == 0) continue;
+        for (int e = 0; e < SIM_EMIT_HISTORY; e++) {
+            if (st[i].emits[e] < 0) continue;
+            long arrival = st[i].emits[e] + xtalk_delay[i][j];
+            if (arrival > st[j].echo_rise && arrival < fall) fall = arrival;
+        }
+    }
+    return (vt >= st[j].echo_rise && vt < fall) ? 1 : 0;
+}
+
+static long sim_now() {
+    return vt;
+}
+
+static void sim_sleep_us(long us) {
+    vt += us;
+}
+
+const pin_backend_t sim_pins = {
+    sim_mode, sim_write, sim_read, sim_now, sim_sleep_us
+};
@@ -0,0 +1,18 @@
+#ifndef SIM_PINS_H
+#define SIM_PINS_H
+
+#include "pins.h"
+#include "ranging.h"
+
+// 시뮬레이션 핀 백엔드 (HC-SR04 모델)
+// - 가상 시간(us)을 사용: sleep 은 시간을 건너뛰고, 핀 읽기 1회는 1us 로 계산
+// - 센서별 목표 거리와 센서 간 크로스토크(다른 센서의 발사음이 도달하는 지연)를 주입 가능
+
+extern const pin_backend_t sim_pins;
+
+void sim_pins_init(const transducer_cfg_t* cfg, int count);
+void sim_set_target(int idx, double cm);                  // cm < 0: 범위 내 물체 없음
+void sim_set_crosstalk(int from, int to, long delay_us);  // 0: 제거
+long sim_now_us();
+
+#endif // SIM_PINS_H
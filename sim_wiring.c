@@ -0,0 +1,136 @@
+#include <stddef.h>
+#include <wiringPi.h>
+#include <wiringPiSPI.h>
+#include <softTone.h>
+
+#include "sim_wiring.h"
+#include "clock.h"
+
+#define SIM_MAX_PINS 64
+#define SIM_MAX_ECHOES   8
+#define SIM_BURST_US     200   // 트리거 후 40kHz 버스트 송신 시간 (에코 핀 상승까지)
+#define SIM_NO_ECHO_US   38000 // 물체가 없을 때 HC-SR04 가 에코 핀을 유지하는 시간
+#define SIM_IDLE_READ_US 100   // 앞으로 바뀔 에코가 없을 때 읽기 1회에 걸리는 가상 시간
+
+static int levels[SIM_MAX_PINS];
+static void (*isrs[SIM_MAX_PINS])(void);
+static void (*tone_fn)(int pin, int freq) = NULL;
+
+// HC-SR04 모델 (sim_pins.c 와 같은 방식, 시각은 clock_now_us())
+typedef struct {
+    int trig_pin, echo_pin;
+    int trig_level;
+    long long trig_high_us;
+    long long echo_rise, echo_fall; // 현재 에코 구간 (-1: 없음)
+    double target_cm;               // -1: 범위 내 물체 없음
+} sim_echo_t;
+
+static sim_echo_t echoes[SIM_MAX_ECHOES];
+static int echo_count = 0;
+
+void sim_wiring_set(int pin, int value) {
+    if (pin < 0 || pin >= SIM_MAX_PINS) return;
+    int rising = (value && !levels[pin]);
+    levels[pin] = value;
+    // 실제로는 wiringPi 의 ISR 쓰레드가 부르지만, 시뮬레이션에서는 시나리오 쓰레드에서 바로 호출
+    if (rising && isrs[pin]) isrs[pin]();
+}
+
+void sim_wiring_on_tone(void (*fn)(int pin, int freq)) {
+    tone_fn = fn;
+}
+
+void sim_wiring_add_echo(int trig_pin, int echo_pin) {
+    if (echo_count >= SIM_MAX_ECHOES) return;
+    sim_echo_t* e = &echoes[echo_count++];
+    e->trig_pin = trig_pin;
+    e->echo_pin = echo_pin;
+    e->trig_level = 0;
+    e->echo_rise = e->echo_fall = -1;
+    e->target_cm = -1;
+}
+
+void sim_wiring_set_range(int echo_pin, double cm) {
+    for (int i = 0; i < echo_count; i++) {
+        if (echoes[i].echo_pin == echo_pin) echoes[i].target_cm = cm;
+    }
+}
+
+static sim_echo_t* find_echo(int pin, int want_echo) {
+    for (int i = 0; i < echo_count; i++) {
+        if ((want_echo ? echoes[i].echo_pin : echoes[i].trig_pin) == pin) return &echoes[i];
+    }
+    return NULL;
+}
+
+// 지금 이후 가장 먼저 바뀌는 에코 핀 시각 (-1: 없음)
+static long long next_echo_edge(long long now) {
+    long long next = -1;
+    for (int i = 0; i < echo_count; i++) {
+        long long edges[2] = { echoes[i].echo_rise, echoes[i].echo_fall };
+        for (int k = 0; k < 2; k++) {
+            if (edges[k] > now && (next < 0 || edges[k] < next)) next = edges[k];
+        }
+    }
+    return next;
+}
+
+// --- wiringPi ---
+
+void pinMode(int pin, int mode) {
+}
+
+void pullUpDnControl(int pin, int pud) {
+}
+
+int digitalRead(int pin) {
+    sim_echo_t* e = find_echo(pin, 1);
+    if (e == NULL) return (pin >= 0 && pin < SIM_MAX_PINS) ? levels[pin] : 0;
+
+    // 에코 핀: 지금 값을 돌려주고, 다음 변화 시각까지 가상 시간을 건너뜀
+    // (스케줄러의 폴링 루프가 1us 씩 수만 번 돌지 않고 에지에서 정확히 다시 읽도록)
+    long long now = clock_now_us();
+    int level = (e->echo_rise >= 0 && now >= e->echo_rise && now < e->echo_fall) ? 1 : 0;
+    long long next = next_echo_edge(now);
+    clock_sleep_us(next > 0 ? (long)(next - now) : SIM_IDLE_READ_US);
+    return level;
+}
+
+void digitalWrite(int pin, int value) {
+    sim_echo_t* e = find_echo(pin, 0);
+    if (e == NULL) return;
+
+    long long now = clock_now_us();
+    if (value == 1 && e->trig_level == 0) {
+        e->trig_high_us = now;
+    }
+    // 10us 이상 HIGH 였다가 떨어지면 발사
+    else if (value == 0 && e->trig_level == 1 && now - e->trig_high_us >= 10) {
+        long long emit = now + SIM_BURST_US;
+        e->echo_rise = emit;
+        e->echo_fall = emit + (e->target_cm >= 0 ? (long long)(e->target_cm / 0.017) : SIM_NO_ECHO_US);
+    }
+    e->trig_level = value;
+}
+
+void delayMicroseconds(unsigned int us) {
+    clock_sleep_us(us);
+}
+
+int wiringPiISR(int pin, int edge, void (*fn)(void)) {
+    if (pin < 0 || pin >= SIM_MAX_PINS) return -1;
+    isrs[pin] = fn; // 상승 에지만 사용 (PIR)
+    return 0;
+}
+
+int softToneCreate(int pin) {
+    return 0;
+}
+
+void softToneWrite(int pin, int freq) {
+    if (tone_fn) tone_fn(pin, freq);
+}
+
+int wiringPiSPIDataRW(int channel, unsigned char* data, int len) {
+    return len;
+}
@@ -0,0 +1,16 @@
+#ifndef SIM_WIRING_H
+#define SIM_WIRING_H
+
+// wiringPi 대체 구현 (시뮬레이션용, -lwiringPi 대신 링크)
+// - 입력 핀 값은 시나리오가 sim_wiring_set() 으로 정하고, 상승 에지에서 등록된 ISR 을 바로 호출
+// - 부저(softTone) 출력은 sim_wiring_on_tone() 로 등록한 함수에 전달 (시각은 clock_now_ms())
+// - 초음파 센서는 HC-SR04 모델: 트리거 핀이 떨어지면 에코 핀이 목표 거리만큼 HIGH
+//   (에코 핀을 읽으면 다음 변화 시각까지 가상 시간을 건너뛰므로 실제 초음파 스케줄러를 그대로 돌릴 수 있음)
+// - SPI(닷매트릭스) / 그 밖의 출력 핀 쓰기는 무시
+
+void sim_wiring_set(int pin, int value);
+void sim_wiring_on_tone(void (*fn)(int pin, int freq));
+void sim_wiring_add_echo(int trig_pin, int echo_pin);  // 초음파 센서 등록 (처음에는 범위 내 물체 없음)
+void sim_wiring_set_range(int echo_pin, double cm);    // 목표 거리 (cm < 0: 범위 내 물체 없음)
+
+#endif // SIM_WIRING_H
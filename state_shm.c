@@ -0,0 +1,99 @@
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#include "config.h"
+#include "watchdog.h"
+#include "state_shm.h"
+#include "clock.h"
+
+_Static_assert(SENTRY_STATE_ZONES == MAX_ZONES, "sentry_state.h SENTRY_STATE_ZONES must match MAX_ZONES");
+_Static_assert(HB_COUNT <= 32, "stalled_mask has 32 bits");
+
+static sentry_state_shm_t* shm = NULL;
+static uint32_t* waiters = NULL; // 기다리는 읽는 쪽 수 (sentry_state_wait 가 증감)
+
+long long state_shm_now_ns() {
+    return clock_now_ns();
+}
+
+// 대기 수 카운터: 읽기 전용 사용자도 증감해야 하므로 0666 (umask 무시)
+// 이전 실행의 값을 지우지 않음 (0 으로 만들면 지금 기다리고 있는 읽는 쪽을 깨우지 못함)
+static uint32_t* open_waiters() {
+    int fd = shm_open(SENTRY_STATE_WAITERS_SHM_NAME, O_CREAT | O_RDWR, 0666);
+    if (fd < 0) {
+        perror(">>> [State] shm_open waiters");
+        return NULL;
+    }
+    fchmod(fd, 0666);
+    if (ftruncate(fd, sizeof(uint32_t)) != 0) {
+        perror(">>> [State] ftruncate waiters");
+        close(fd);
+        return NULL;
+    }
+    void* p = mmap(NULL, sizeof(uint32_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        perror(">>> [State] mmap waiters");
+        return NULL;
+    }
+    return (uint32_t*)p;
+}
+
+int state_shm_init() {
+    // 카운터가 먼저 있어야 magic 을 본 읽는 쪽이 연결할 수 있음
+    waiters = open_waiters();
+    if (waiters == NULL) return -1;
+
+    int fd = shm_open(SENTRY_STATE_SHM_NAME, O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+        perror(">>> [State] shm_open");
+        return -1;
+    }
+    // sudo 로 실행해도 다른 사용자의 대시보드가 읽을 수 있도록 (umask 무시)
+    fchmod(fd, 0644);
+    if (ftruncate(fd, sizeof(sentry_state_shm_t)) != 0) {
+        perror(">>> [State] ftruncate");
+        close(fd);
+        return -1;
+    }
+    void* p = mmap(NULL, sizeof(sentry_state_shm_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        perror(">>> [State] mmap");
+        return -1;
+    }
+
+    shm = (sentry_state_shm_t*)p;
+    // 이전 실행이 남긴 내용은 지우고, 읽는 쪽이 보기 전에 헤더를 마지막에 채움
+    uint32_t seq = __atomic_load_n(&shm->seq, __ATOMIC_RELAXED);
+    __atomic_store_n(&shm->magic, 0, __ATOMIC_RELAXED);
+    memset(&shm->state, 0, sizeof(shm->state));
+    shm->layout = SENTRY_STATE_LAYOUT;
+    shm->size = sizeof(sentry_state_shm_t);
+    __atomic_store_n(&shm->seq, (seq + 2) & ~1u, __ATOMIC_RELAXED); // 기다리던 읽는 쪽이 있으면 변경으로 보이도록
+    __atomic_store_n(&shm->magic, SENTRY_STATE_MAGIC, __ATOMIC_RELEASE);
+
+    printf(">>> [State] Publishing state to shm %s (%zu bytes)\n", SENTRY_STATE_SHM_NAME, sizeof(sentry_state_shm_t));
+    return 0;
+}
+
+void state_shm_publish(const sentry_state_t* s) {
+    if (shm == NULL) return;
+
+    sentry_state_write(shm, s);
+
+    // 기다리는 읽는 쪽이 있을 때만 깨움 (대시보드가 없으면 루프당 시스템 콜 0번)
+    // seq 기록 -> 카운터 확인 순서가 바뀌지 않도록 전체 배리어 (sentry_state_wait 의 반대 순서와 짝)
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(waiters, __ATOMIC_RELAXED) != 0) {
+        syscall(SYS_futex, &shm->seq, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+    }
+}
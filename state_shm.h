@@ -0,0 +1,13 @@
+#ifndef STATE_SHM_H
+#define STATE_SHM_H
+
+#include "sentry_state.h"
+
+// 공유 메모리 상태 미러 - 쓰는 쪽 (메인 루프 전용, 레이아웃과 읽는 방법은 sentry_state.h)
+// - 쓰는 쪽은 메인 쓰레드 하나뿐이므로 락 없이 seqlock 만 사용
+
+int  state_shm_init();                          // 공유 메모리 생성 (실패해도 시스템은 계속 동작)
+void state_shm_publish(const sentry_state_t* s); // 사본 기록 + 기다리는 읽는 쪽 깨우기
+long long state_shm_now_ns();                   // clock_now_ns() (update_ns 등과 같은 기준, 실제 시계면 CLOCK_MONOTONIC)
+
+#endif // STATE_SHM_H
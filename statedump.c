@@ -0,0 +1,225 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#include "sentry_state.h"
+
+// =========================================================
+// 공유 메모리 상태 미러 확인 도구
+// =========================================================
+// 사용법: ./statedump           현재 상태 1회 출력
+//         ./statedump -w        바뀔 때마다 출력 (futex 대기, 2초 동안 변화가 없으면 stale 표시)
+//         ./statedump -b 5      5초 동안 최대 속도로 읽어서 초당 읽기 횟수 / 재시도 측정
+//         ./statedump -t 5      5초 동안 seqlock 검사 (sentry_system 없이 자체 쓰는 쪽으로, 깨진 사본 수 출력)
+// sentry_system 과 같은 장치에서 실행 (sudo 불필요)
+
+static const char* mode_name(int mode) {
+    switch (mode) {
+        case 0: return "CLEAR";
+        case 1: return "SAFE";
+        case 2: return "WARN";
+        case 3: return "DANGER";
+        case 99: return "EXIT";
+        default: return "?";
+    }
+}
+
+static long long now_ns() {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (long long)t.tv_sec * 1000000000LL + t.tv_nsec;
+}
+
+static void print_state(const sentry_state_t* s, uint32_t seq) {
+    static const char* level_names[] = { "IDLE", "NORMAL", "ACTIVE" };
+    static const char* hb_names[] = SENTRY_STATE_HB_NAMES;
+    long long now = now_ns();
+
+    printf("--- seq %u, pid %d, config v%u, updated %.1f ms ago ---\n",
+           seq, s->pid, s->config_version, (now - s->update_ns) / 1e6);
+    printf("mode      : %s for %.1f s (rate %s)%s%s\n", mode_name(s->mode), (now - s->mode_since_ns) / 1e9,
+           (s->rate_level >= 0 && s->rate_level <= 2) ? level_names[s->rate_level] : "?",
+           s->target_verified ? ", target verified" : "", s->degraded ? ", DEGRADED (PIR only)" : "");
+    printf("incident  : %lld, distance used %.1f cm\n", (long long)s->incident_id, s->dist_used);
+    printf("camera    : %s, zones 0x%x\n", s->camera_detected ? "target" : "none", s->camera_zone_mask);
+    printf("pir       : %d\n", s->pir_detected);
+    for (int z = 0; z < SENTRY_STATE_ZONES; z++) {
+        const sentry_zone_state_t* zs = &s->zones[z];
+        if (zs->measured_ns == 0) continue;
+        printf("zone %d    : %.1f cm (%.0f ms ago, #%u)\n", z, zs->dist, (now - zs->measured_ns) / 1e6, zs->seq);
+    }
+    printf("lock      : motor %s, users %d, admin override %d\n",
+           s->motor_locked ? "locked" : "unlocked", s->auth_user_count, s->admin_override);
+    printf("stalled   :");
+    if (s->stalled_mask == 0) printf(" none");
+    for (int i = 0; i < (int)(sizeof(hb_names) / sizeof(hb_names[0])); i++) {
+        if (s->stalled_mask & (1u << i)) printf(" %s", hb_names[i]);
+    }
+    printf("\ncounters  : loops %llu, mode changes %llu, alerts %llu, captures %llu\n",
+           (unsigned long long)s->loops, (unsigned long long)s->mode_changes,
+           (unsigned long long)s->alerts_sent, (unsigned long long)s->captures);
+    printf("ranging   : accepted %llu, timeouts %llu, crosstalk %llu\n",
+           (unsigned long long)s->ranging_accepted, (unsigned long long)s->ranging_timeouts,
+           (unsigned long long)s->ranging_crosstalk);
+    fflush(stdout);
+}
+
+// 최대 속도로 읽기: 읽는 쪽이 많아도 쓰는 쪽에 영향이 없는지 / 읽기 비용 확인용
+static void bench(const sentry_state_shm_t* shm, double seconds) {
+    sentry_state_t s;
+    uint32_t seq, last_seq = 0;
+    unsigned long reads = 0, failed = 0, versions = 0;
+    long long max_read_ns = 0;
+    long long end = now_ns() + (long long)(seconds * 1e9);
+
+    long long t = now_ns();
+    while (t < end) {
+        if (sentry_state_read(shm, &s, &seq) == 0) {
+            reads++;
+            if (seq != last_seq) {
+                versions++;
+                last_seq = seq;
+            }
+        } else {
+            failed++;
+        }
+        long long t2 = now_ns();
+        if (t2 - t > max_read_ns) max_read_ns = t2 - t;
+        t = t2;
+    }
+    printf("=== statedump bench (%.1f s) ===\n", seconds);
+    printf("reads      : %lu (%.2f M/s, %.0f ns each)\n", reads, reads / seconds / 1e6, seconds * 1e9 / (reads ? reads : 1));
+    printf("failed     : %lu (writer busy for 1000 tries)\n", failed);
+    printf("versions   : %lu seen (%.1f /s)\n", versions, versions / seconds);
+    printf("slowest    : %.1f us (includes preemption)\n", max_read_ns / 1e3);
+}
+
+// seqlock 검사: 익명 공유 메모리에 자식 프로세스가 sentry_state_write() 로 번호 n 을 모든 8바이트 칸에 기록,
+// 부모는 sentry_state_read() 로 읽어 모든 칸이 같은지 확인 (sentry_system 의 /sentry_state 는 건드리지 않음)
+// 비교용으로 seqlock 없이 그냥 복사한 사본도 같은 방법으로 세어 검사가 깨진 사본을 잡아내는지 보여 줌
+#define CHECK_WORDS (sizeof(sentry_state_t) / sizeof(uint64_t))
+_Static_assert(sizeof(sentry_state_t) % sizeof(uint64_t) == 0, "sentry_state_t must be a whole number of 8-byte words");
+
+static int torn_copy(const sentry_state_t* s) {
+    const uint64_t* w = (const uint64_t*)s;
+    for (size_t i = 1; i < CHECK_WORDS; i++) {
+        if (w[i] != w[0]) return 1;
+    }
+    return 0;
+}
+
+static int check(double seconds) {
+    sentry_state_shm_t* shm = mmap(NULL, sizeof(*shm), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shm == MAP_FAILED) {
+        perror(">>> [State] mmap");
+        return 1;
+    }
+    memset(shm, 0, sizeof(*shm));
+    volatile int* stop = (volatile int*)mmap(NULL, sizeof(int), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (stop == MAP_FAILED) {
+        perror(">>> [State] mmap");
+        return 1;
+    }
+    *stop = 0;
+
+    pid_t writer = fork();
+    if (writer < 0) {
+        perror(">>> [State] fork");
+        return 1;
+    }
+    if (writer == 0) {
+        sentry_state_t s;
+        uint64_t* w = (uint64_t*)&s;
+        for (uint64_t n = 1; !*stop; n++) {
+            for (size_t i = 0; i < CHECK_WORDS; i++) w[i] = n;
+            sentry_state_write(shm, &s);
+        }
+        _exit(0);
+    }
+
+    sentry_state_t s;
+    uint32_t seq;
+    unsigned long reads = 0, failed = 0, torn = 0, raw_reads = 0, raw_torn = 0;
+    long long end = now_ns() + (long long)(seconds * 1e9);
+    while (now_ns() < end) {
+        for (int i = 0; i < 1000; i++) {
+            if (sentry_state_read(shm, &s, &seq) != 0) {
+                failed++;
+                continue;
+            }
+            reads++;
+            torn += torn_copy(&s);
+        }
+        // 비교용: seqlock 없이 복사 (쓰는 쪽이 항상 기록 중이므로 여기서는 깨진 사본이 나와야 정상)
+        for (int i = 0; i < 100; i++) {
+            memcpy(&s, (const void*)&shm->state, sizeof(s));
+            raw_reads++;
+            raw_torn += torn_copy(&s);
+        }
+    }
+    *stop = 1;
+    waitpid(writer, NULL, 0);
+
+    printf("=== statedump seqlock check (%.1f s, %zu words per copy) ===\n", seconds, CHECK_WORDS);
+    printf("versions   : %llu written\n", (unsigned long long)((const uint64_t*)&shm->state)[0]);
+    printf("seqlock    : %lu reads, %lu torn, %lu failed (writer busy for 1000 tries)\n", reads, torn, failed);
+    printf("no seqlock : %lu reads, %lu torn (shows the check can see a torn copy)\n", raw_reads, raw_torn);
+    return torn ? 1 : 0;
+}
+
+int main(int argc, char* argv[]) {
+    int watch = 0;
+    double bench_s = 0, check_s = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "wb:t:")) != -1) {
+        switch (opt) {
+            case 'w': watch = 1; break;
+            case 'b': bench_s = atof(optarg); break;
+            case 't': check_s = atof(optarg); break;
+            default:
+                fprintf(stderr, "Usage: %s [-w] [-b seconds] [-t seconds]\n", argv[0]);
+                return 1;
+        }
+    }
+
+    if (check_s > 0) {
+        return check(check_s);
+    }
+
+    const sentry_state_shm_t* shm = sentry_state_open();
+    if (shm == NULL) {
+        fprintf(stderr, ">>> [State] %s not available (sentry_system not running or layout mismatch)\n", SENTRY_STATE_SHM_NAME);
+        return 1;
+    }
+
+    if (bench_s > 0) {
+        bench(shm, bench_s);
+        return 0;
+    }
+
+    sentry_state_t s;
+    uint32_t seq;
+    if (sentry_state_read(shm, &s, &seq) != 0) {
+        fprintf(stderr, ">>> [State] Could not get a consistent snapshot\n");
+        return 1;
+    }
+    print_state(&s, seq);
+
+    while (watch) {
+        if (sentry_state_wait(shm, seq, 2000) != 0) {
+            printf(">>> [State] stale: no update for 2 s (pid %d %s)\n", s.pid,
+                   sentry_state_pid_alive(s.pid) ? "alive" : "gone");
+            fflush(stdout);
+            continue;
+        }
+        if (sentry_state_read(shm, &s, &seq) == 0) {
+            print_state(&s, seq);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include <stdio.h>
+#include <unistd.h>
+
+#include "config.h"
+#include "watchdog.h"
+#include "boot.h"
+#include "clock.h"
+#include "network.h"
+#include "governor.h"
+#include "runtime_config.h"
+
+#define WATCHDOG_PERIOD_MS 100 // 감시 주기
+
+typedef struct {
+    const char* name;
+    int deadline_ms;  // 이 시간 동안 하트비트가 없으면 멈춤으로 판단 (SLO)
+    int grace_ms;     // 첫 하트비트 전 허용 시간 (부팅 중 오탐 방지)
+
+    // --- 작업 쓰레드가 쓰는 값 (원자적 store) ---
+    unsigned long count;
+    long last_us;     // 마지막 하트비트 시각 (boot 기준 us, 0: 아직 없음)
+    long max_gap_us;  // 관측된 최대 하트비트 간격
+
+    // --- 감시 쓰레드만 쓰는 값 ---
+    int stalled;
+    long stall_start_us;
+    long stall_count;
+    long longest_stall_us;
+} heartbeat_t;
+
+static heartbeat_t hb[HB_COUNT] = {
+    [HB_MAIN]        = { "main_loop",    500,  5000 },
+    [HB_DISPLAY]     = { "display",      2000, 5000 }, // IDLE 에서는 1초 주기로 갱신
+    [HB_BUZZER]      = { "buzzer",       2000, 5000 },
+    [HB_PIPE_READER] = { "pipe_reader",  500,  5000 },
+    [HB_CAMERA_FEED] = { "camera_feed",  1000, 20000 }, // 카메라 초기화가 가장 느림, 느린 fps 설정이면 늘어남 (deadline_of)
+    [HB_BLUETOOTH]   = { "bluetooth",    1000, 5000 },
+    [HB_WIFI]        = { "wifi_server",  1500, 5000 },
+    [HB_RANGING]     = { "ranging",      500,  5000 },
+};
+
+static long watchdog_start_us = 0;
+
+// 실제 판단 기준 (ms)
+// 카메라 피드는 가장 느린 detector_fps 의 프레임 간격 2.5배보다 짧으면 정상 동작 중에도 멈춤으로 판단하므로 늘림
+// (예: IDLE 1 fps -> 1000ms 마다 한 줄 -> 2500ms)
+static int deadline_of(int id) {
+    int deadline = hb[id].deadline_ms;
+    if (id == HB_CAMERA_FEED) {
+        for (int lv = 0; lv < RATE_LEVELS; lv++) {
+            int frame_ms = 1000 / rcfg_rate(lv, GOV_DETECTOR_FPS);
+            if (frame_ms * 5 / 2 > deadline) deadline = frame_ms * 5 / 2;
+        }
+    }
+    return deadline;
+}
+
+void watchdog_init() {
+    watchdog_start_us = boot_elapsed_us();
+}
+
+void watchdog_beat(int id) {
+    heartbeat_t* h = &hb[id];
+    long now = boot_elapsed_us();
+    long last = h->last_us; // 이 값은 자기 쓰레드만 쓰므로 그냥 읽어도 됨
+
+    if (last != 0 && now - last > h->max_gap_us) {
+        __atomic_store_n(&h->max_gap_us, now - last, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&h->count, h->count + 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&h->last_us, now, __ATOMIC_RELEASE);
+}
+
+int watchdog_is_stalled(int id) {
+    return __atomic_load_n(&hb[id].stalled, __ATOMIC_ACQUIRE);
+}
+
+void watchdog_report() {
+    printf(">>> [Watchdog] %-12s %8s %8s %12s %12s %10s\n",
+           "thread", "beats", "stalls", "longest(ms)", "max_gap(ms)", "slo(ms)");
+    for (int i = 0; i < HB_COUNT; i++) {
+        heartbeat_t* h = &hb[i];
+        printf(">>> [Watchdog] %-12s %8lu %8ld %12.1f %12.1f %10d\n", h->name,
+               __atomic_load_n(&h->count, __ATOMIC_RELAXED), h->stall_count,
+               h->longest_stall_us / 1000.0,
+               __atomic_load_n(&h->max_gap_us, __ATOMIC_RELAXED) / 1000.0, deadline_of(i));
+    }
+}
+
+// [쓰레드] 하트비트 감시
+void* watchdogThreadFunc(void* arg) {
+    while (current_mode != MODE_EXIT) {
+        long now = boot_elapsed_us();
+
+        for (int i = 0; i < HB_COUNT; i++) {
+            heartbeat_t* h = &hb[i];
+            long last = __atomic_load_n(&h->last_us, __ATOMIC_ACQUIRE);
+            int deadline_ms = deadline_of(i);
+
+            // 아직 한 번도 안 뛰었으면 감시 시작 + grace 를 기준으로 판단
+            long due = (last == 0) ? watchdog_start_us + h->grace_ms * 1000L
+                                   : last + deadline_ms * 1000L;
+
+            if (!h->stalled && now > due) {
+                h->stall_start_us = (last == 0) ? watchdog_start_us : last;
+                h->stall_count++;
+                __atomic_store_n(&h->stalled, 1, __ATOMIC_RELEASE);
+
+                printf("!!! [Watchdog] %s stalled (no heartbeat for %.1f ms, SLO %d ms)\n",
+                       h->name, (now - h->stall_start_us) / 1000.0, deadline_ms);
+                if (i == HB_CAMERA_FEED) {
+                    printf("!!! [Watchdog] Camera feed lost -> degraded mode (PIR only)\n");
+                }
+                send_health_alert(h->name, 1, (now - h->stall_start_us) / 1000);
+            }
+            else if (h->stalled && last != 0 && now <= last + deadline_ms * 1000L) {
+                long stall_us = last - h->stall_start_us;
+                if (stall_us > h->longest_stall_us) h->longest_stall_us = stall_us;
+                __atomic_store_n(&h->stalled, 0, __ATOMIC_RELEASE);
+
+                printf(">>> [Watchdog] %s recovered after %.1f ms stall\n", h->name, stall_us / 1000.0);
+                send_health_alert(h->name, 0, stall_us / 1000);
+            }
+        }
+
+        clock_sleep_ms(WATCHDOG_PERIOD_MS);
+    }
+    return NULL;
+}
@@ -0,0 +1,28 @@
+#ifndef WATCHDOG_H
+#define WATCHDOG_H
+
+// 쓰레드별 하트비트 감시 (Watchdog)
+// - 각 작업 루프는 한 바퀴 돌 때마다 watchdog_beat() 호출 (원자적 store 몇 번)
+// - 감시 쓰레드가 주기적으로 마감 시간(deadline)을 넘긴 하트비트를 찾아
+//   경보를 보내고, 복구되면 멈춰 있던 시간을 기록
+
+enum {
+    HB_MAIN = 0,      // 메인 루프 (센서 융합)
+    HB_DISPLAY,       // 닷매트릭스 쓰레드
+    HB_BUZZER,        // 부저 쓰레드
+    HB_PIPE_READER,   // FIFO 리더 쓰레드 루프
+    HB_CAMERA_FEED,   // Python Detector 로부터 감지 결과가 실제로 들어오는지
+    HB_BLUETOOTH,     // 블루투스 쓰레드
+    HB_WIFI,          // Wi-Fi 서버 쓰레드
+    HB_RANGING,       // 초음파 스케줄러 쓰레드
+    HB_COUNT
+};
+
+void watchdog_init();            // 감시 시작 시각 기록 (쓰레드 생성 전에 호출)
+void watchdog_beat(int id);      // 하트비트 갱신 (해당 쓰레드에서만 호출)
+int  watchdog_is_stalled(int id); // 현재 멈춤 상태인지 (1: 멈춤)
+void watchdog_report();          // 쓰레드별 멈춤 횟수/최장 시간/최대 간격 출력
+
+void* watchdogThreadFunc(void* arg);
+
+#endif // WATCHDOG_H